@@ -0,0 +1,162 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "OrderBook.h"
+#include "IngressQueue.h"
+#include "Dispatcher.h"
+#include "MarketDataPublisher.h"
+#include "Protocol.h"
+#include "Transport.h"
+#include "SeqLock.h"
+
+// Fully polled order-entry path over Transports. Each Poll receives one burst
+// per session, decodes the frames into the ingress queue, drains the queue
+// into the book and sends the execution reports back as one burst per
+// session. Market data, when a publisher is attached, goes out through its
+// own transport. With ShmTransport nothing on this path makes a system call.
+class BookEngine
+{
+public:
+    static constexpr std::size_t BurstSize = 32;
+
+    BookEngine(OrderBook& book, IngressQueue& ingress, MarketDataPublisher* publisher = nullptr,
+        SeqLock<TopOfBook>* topOfBook = nullptr)
+        : book_{ book }
+        , ingress_{ ingress }
+        , publisher_{ publisher }
+        , topOfBook_{ topOfBook }
+    {}
+
+    std::uint32_t AddSession(Transport& transport)
+    {
+        sessions_.push_back(Session{ &transport, {}, {}, 0 });
+        return static_cast<std::uint32_t>(sessions_.size() - 1);
+    }
+
+    // One iteration of the loop. Returns the number of commands processed so
+    // an event loop can tell busy iterations from idle ones.
+    std::size_t Poll()
+    {
+        if (referenceData_) referenceData_->Refresh();
+
+        std::size_t processed = 0;
+        for (std::uint32_t sessionId = 0; sessionId < sessions_.size(); ++sessionId)
+        {
+            std::array<Frame, BurstSize> frames;
+            const std::size_t received = sessions_[sessionId].transport_->Receive(frames);
+            for (std::size_t i = 0; i < received; ++i)
+                processed += DecodeFrame(sessionId, frames[i]);
+        }
+
+        processed += Drain();
+        if (processed && topOfBook_) topOfBook_->Store(book_.GetTopOfBook());
+        if (publisher_) publisher_->Flush();
+        for (auto& session : sessions_) Flush(session);
+        return processed;
+    }
+
+    void OnExecutionReport(std::uint32_t sessionId, const Protocol::ExecutionReportMessage& report)
+    {
+        Queue(sessions_[sessionId], &report, sizeof(report));
+    }
+
+    void OnFill(std::uint32_t sessionId, const Protocol::FillMessage& fill)
+    {
+        Queue(sessions_[sessionId], &fill, sizeof(fill));
+    }
+
+    void OnBookUpdate(const OrderBook& book, Side side, Price price, const Trades& trades)
+    {
+        if (publisher_) publisher_->PublishAdd(book, side, price, trades, eventTimeNs_);
+    }
+
+    // Refreshed at the top of every Poll, the engine's quiescent point.
+    void AttachReferenceData(ReferenceDataReader& reader) { referenceData_ = &reader; }
+
+    std::uint64_t MalformedFrames() const { return malformedFrames_; }
+
+private:
+    using FrameBuffer = std::array<char, Transport::MaxFrameSize>;
+
+    struct Session
+    {
+        Transport* transport_;
+        std::vector<FrameBuffer> frames_;
+        std::vector<std::size_t> sizes_;
+        std::size_t sent_ = 0;
+    };
+
+    // A frame carries whole protocol messages; a frame that ends mid-message
+    // is dropped from that point on.
+    std::size_t DecodeFrame(std::uint32_t sessionId, const Frame& frame)
+    {
+        using namespace Protocol;
+
+        std::size_t processed = 0;
+        std::size_t offset = 0;
+        while (offset < frame.length_)
+        {
+            MessageHeader header;
+            Command command;
+            if (PeekMessage(frame.data_ + offset, frame.length_ - offset, header) != ParseResult::Complete
+                || !ToCommand(header, frame.data_ + offset, sessionId, command)) {
+                ++malformedFrames_;
+                break;
+            }
+            // The engine is the queue's only consumer, so draining always
+            // makes room.
+            while (!ingress_.try_push(command)) processed += Drain();
+            offset += header.length_;
+        }
+        return processed;
+    }
+
+    std::size_t Drain()
+    {
+        eventTimeNs_ = publisher_ ? MarketData::NowNs() : 0;
+        return DrainIngress(ingress_, book_, *this, ingress_.capacity());
+    }
+
+    void Queue(Session& session, const void* data, std::size_t length)
+    {
+        if (session.sizes_.empty() || session.sizes_.back() + length > Transport::MaxFrameSize) {
+            if (session.frames_.size() == session.sizes_.size()) session.frames_.emplace_back();
+            session.sizes_.push_back(0);
+        }
+        std::memcpy(session.frames_[session.sizes_.size() - 1].data() + session.sizes_.back(), data, length);
+        session.sizes_.back() += length;
+    }
+
+    // Reports the transport could not take stay queued for the next Poll.
+    void Flush(Session& session)
+    {
+        while (session.sent_ < session.sizes_.size())
+        {
+            std::array<Frame, BurstSize> frames;
+            std::size_t count = 0;
+            for (; count < BurstSize && session.sent_ + count < session.sizes_.size(); ++count)
+                frames[count] = Frame{ session.frames_[session.sent_ + count].data(), session.sizes_[session.sent_ + count] };
+
+            const std::size_t sent = session.transport_->Send(std::span<const Frame>{ frames.data(), count });
+            session.sent_ += sent;
+            if (sent < count) break;
+        }
+
+        if (session.sent_ == session.sizes_.size()) {
+            session.sizes_.clear();
+            session.sent_ = 0;
+        }
+    }
+
+    OrderBook& book_;
+    IngressQueue& ingress_;
+    MarketDataPublisher* publisher_;
+    SeqLock<TopOfBook>* topOfBook_;
+    ReferenceDataReader* referenceData_ = nullptr;
+    std::vector<Session> sessions_;
+    std::uint64_t eventTimeNs_ = 0;
+    std::uint64_t malformedFrames_ = 0;
+};
@@ -0,0 +1,166 @@
+#pragma once
+#include <map>
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "MarketData.h"
+
+struct RecoveryStats
+{
+    std::uint64_t recoveries_ = 0;
+    std::uint64_t snapshotsApplied_ = 0;
+    std::uint64_t snapshotsSkipped_ = 0;
+    std::uint64_t deltasReplayed_ = 0;
+    std::uint64_t deltasDiscarded_ = 0;
+};
+
+// Consumer-side book image kept in sync from the delta feed, falling back to
+// the snapshot channel on late join or after a gap. While recovering, deltas
+// are buffered; once a complete snapshot tagged with sequence S arrives, the
+// image is replaced and buffered deltas from S onwards are replayed on top.
+class BookRecovery
+{
+public:
+    using BidLevels = std::map<Price, Quantity, std::greater<Price>>;
+    using AskLevels = std::map<Price, Quantity, std::less<Price>>;
+
+    explicit BookRecovery(std::size_t maxBuffered = 1 << 20)
+        : maxBuffered_{ maxBuffered }
+    {}
+
+    void OnDelta(std::uint64_t sequence, const MarketData::BookDelta& delta)
+    {
+        if (synced_) {
+            if (sequence < expected_) return;
+            if (sequence == expected_) {
+                Apply(delta);
+                ++expected_;
+                return;
+            }
+            synced_ = false;
+            ++stats_.recoveries_;
+        }
+
+        if (buffered_.size() == maxBuffered_) {
+            buffered_.pop_front();
+            ++stats_.deltasDiscarded_;
+        }
+        buffered_.push_back({ sequence, delta });
+    }
+
+    void OnSnapshotDatagram(const char* data, std::size_t length)
+    {
+        using namespace MarketData;
+
+        if (synced_) return;
+        if (length < sizeof(PacketHeader) + sizeof(SnapshotHeader)) return;
+
+        PacketHeader packetHeader;
+        SnapshotHeader snapshotHeader;
+        std::memcpy(&packetHeader, data, sizeof(packetHeader));
+        std::memcpy(&snapshotHeader, data + sizeof(packetHeader), sizeof(snapshotHeader));
+        if (sizeof(PacketHeader) + sizeof(SnapshotHeader) + packetHeader.messageCount_ * sizeof(SnapshotLevel) > length) return;
+        if (snapshotHeader.fragmentIndex_ >= snapshotHeader.fragmentCount_) return;
+
+        if (!assembling_ || snapshotHeader.snapshotId_ != snapshotId_) {
+            assembling_ = true;
+            snapshotId_ = snapshotHeader.snapshotId_;
+            snapshotSequence_ = packetHeader.sequence_;
+            fragmentsSeen_.assign(snapshotHeader.fragmentCount_, false);
+            fragmentsMissing_ = snapshotHeader.fragmentCount_;
+            levels_.clear();
+        }
+        if (fragmentsSeen_[snapshotHeader.fragmentIndex_]) return;
+        fragmentsSeen_[snapshotHeader.fragmentIndex_] = true;
+        --fragmentsMissing_;
+
+        const char* cursor = data + sizeof(PacketHeader) + sizeof(SnapshotHeader);
+        for (std::uint16_t i = 0; i < packetHeader.messageCount_; ++i, cursor += sizeof(SnapshotLevel))
+        {
+            SnapshotLevel level;
+            std::memcpy(&level, cursor, sizeof(level));
+            levels_.push_back(level);
+        }
+
+        if (fragmentsMissing_ == 0) {
+            assembling_ = false;
+            TryApplySnapshot();
+        }
+    }
+
+    bool IsSynced() const { return synced_; }
+    std::uint64_t ExpectedSequence() const { return expected_; }
+    const BidLevels& GetBids() const { return bids_; }
+    const AskLevels& GetAsks() const { return asks_; }
+    const RecoveryStats& Stats() const { return stats_; }
+
+private:
+    struct BufferedDelta
+    {
+        std::uint64_t sequence_;
+        MarketData::BookDelta delta_;
+    };
+
+    void Apply(const MarketData::BookDelta& delta)
+    {
+        if (delta.type_ != MarketData::DeltaType::Level) return;
+        if (static_cast<Side>(delta.side_) == Side::Buy) {
+            if (delta.quantity_) bids_[delta.price_] = delta.quantity_;
+            else bids_.erase(delta.price_);
+        } else {
+            if (delta.quantity_) asks_[delta.price_] = delta.quantity_;
+            else asks_.erase(delta.price_);
+        }
+    }
+
+    void TryApplySnapshot()
+    {
+        while (!buffered_.empty() && buffered_.front().sequence_ < snapshotSequence_) buffered_.pop_front();
+
+        // The buffer must continue exactly where the snapshot ends; otherwise
+        // wait for a later snapshot.
+        std::uint64_t next = snapshotSequence_;
+        for (const auto& entry : buffered_)
+        {
+            if (entry.sequence_ != next) {
+                ++stats_.snapshotsSkipped_;
+                return;
+            }
+            ++next;
+        }
+
+        bids_.clear();
+        asks_.clear();
+        for (const auto& level : levels_)
+        {
+            if (static_cast<Side>(level.side_) == Side::Buy) bids_.emplace(level.price_, level.quantity_);
+            else asks_.emplace(level.price_, level.quantity_);
+        }
+        for (const auto& entry : buffered_) Apply(entry.delta_);
+
+        stats_.deltasReplayed_ += buffered_.size();
+        ++stats_.snapshotsApplied_;
+        buffered_.clear();
+        expected_ = next;
+        synced_ = true;
+    }
+
+    std::size_t maxBuffered_;
+    bool synced_ = false;
+    std::uint64_t expected_ = 0;
+    std::deque<BufferedDelta> buffered_;
+
+    bool assembling_ = false;
+    std::uint32_t snapshotId_ = 0;
+    std::uint64_t snapshotSequence_ = 0;
+    std::vector<bool> fragmentsSeen_;
+    std::size_t fragmentsMissing_ = 0;
+    std::vector<MarketData::SnapshotLevel> levels_;
+
+    BidLevels bids_;
+    AskLevels asks_;
+    RecoveryStats stats_;
+};
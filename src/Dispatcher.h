@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+
+#include "OrderBook.h"
+#include "IngressQueue.h"
+#include "Protocol.h"
+
+// Sinks that also publish market data receive one call per level a command
+// changed on its own side, with the trades it produced.
+template<typename Sink>
+concept BookUpdateSink = requires(Sink& sink, const OrderBook& book, Side side, Price price, const Trades& trades)
+{
+    sink.OnBookUpdate(book, side, price, trades);
+};
+
+// Drains up to maxCommands from the ingress queue into the book and hands the
+// resulting execution reports to the sink. Fills are reported to the session
+// that sent the aggressing command. Cancels and amends are taken ahead of adds
+// (see IngressQueue), except that the adds queued before one that targets an
+// id the book has never accepted run first.
+//
+// ReportSink must provide:
+//   void OnExecutionReport(std::uint32_t sessionId, const Protocol::ExecutionReportMessage&);
+//   void OnFill(std::uint32_t sessionId, const Protocol::FillMessage&);
+// and may provide OnBookUpdate (see BookUpdateSink).
+template<typename ReportSink>
+std::size_t DrainIngress(IngressQueue& queue, OrderBook& book, ReportSink& sink, std::size_t maxCommands)
+{
+    using namespace Protocol;
+
+    auto ReportTrades = [&sink](const Command& command, const Trades& trades)
+    {
+        for (const auto& trade : trades)
+        {
+            const bool isBid = trade.GetBidTrade().orderId_ == command.orderId_;
+            const bool isAsk = trade.GetAskTrade().orderId_ == command.orderId_;
+            if (!isBid && !isAsk) continue;
+
+            const TradeInfo& own = isBid ? trade.GetBidTrade() : trade.GetAskTrade();
+            const TradeInfo& contra = isBid ? trade.GetAskTrade() : trade.GetBidTrade();
+
+            sink.OnFill(command.sessionId_, FillMessage{
+                MakeHeader<FillMessage>(MessageType::Fill),
+                own.orderId_, contra.orderId_, own.price_, own.quantity_ });
+        }
+    };
+
+    auto ToExecStatus = [](OrderStatus status)
+    {
+        switch (status)
+        {
+        case OrderStatus::New: return ExecStatus::New;
+        case OrderStatus::PartiallyFilled: return ExecStatus::PartiallyFilled;
+        case OrderStatus::Filled: return ExecStatus::Filled;
+        case OrderStatus::Killed: return ExecStatus::Killed;
+        case OrderStatus::Cancelled: return ExecStatus::Cancelled;
+        case OrderStatus::Rejected: break;
+        }
+        return ExecStatus::Rejected;
+    };
+
+    auto Describe = [&ToExecStatus](ExecutionReportMessage& report, const ExecutionReport& result)
+    {
+        report.filledQuantity_ = result.filledQuantity_;
+        report.status_ = ToExecStatus(result.status_);
+        report.reason_ = result.rejectReason_;
+        report.resting_ = result.resting_;
+    };
+
+    static const Trades noTrades;
+    auto BookUpdate = [&sink, &book](Side side, Price price, const Trades& trades)
+    {
+        if constexpr (BookUpdateSink<ReportSink>) sink.OnBookUpdate(book, side, price, trades);
+    };
+
+    auto Execute = [&](const Command& command)
+    {
+        ExecutionReportMessage report{ MakeHeader<ExecutionReportMessage>(MessageType::ExecutionReport),
+            command.orderId_, 0, ExecStatus::New, ErrorCode::None, 0 };
+
+        switch (command.type_)
+        {
+        case CommandType::Add:
+        {
+            const ExecutionReport result = book.AddOrder(command.orderType_, command.orderId_, command.side_, command.price_, command.quantity_);
+            Describe(report, result);
+            if (result.IsRejected()) break;
+            const Trades& trades = book.GetTrades();
+            ReportTrades(command, trades);
+            BookUpdate(command.side_, command.price_, trades);
+            break;
+        }
+        case CommandType::Cancel:
+        {
+            const ExecutionReport result = book.CancelOrder(command.orderId_);
+            Describe(report, result);
+            if (result.IsRejected()) break;
+            BookUpdate(result.fromSide_, result.fromPrice_, noTrades);
+            break;
+        }
+        case CommandType::Modify:
+        {
+            const ExecutionReport result = book.MatchOrder(OrderModify{ command.orderId_, command.side_, command.price_, command.quantity_ });
+            Describe(report, result);
+            if (result.IsRejected()) break;
+            const Trades& trades = book.GetTrades();
+            ReportTrades(command, trades);
+            if (result.fromSide_ != command.side_ || result.fromPrice_ != command.price_)
+                BookUpdate(result.fromSide_, result.fromPrice_, noTrades);
+            BookUpdate(command.side_, command.price_, trades);
+            break;
+        }
+        case CommandType::Replace:
+        {
+            const ExecutionReport result = book.Replace(command.replacedOrderId_, command.orderId_, command.price_, command.quantity_);
+            Describe(report, result);
+            if (result.IsRejected()) break;
+            const Trades& trades = book.GetTrades();
+            ReportTrades(command, trades);
+            if (result.fromPrice_ != command.price_) BookUpdate(result.fromSide_, result.fromPrice_, noTrades);
+            BookUpdate(result.fromSide_, command.price_, trades);
+            break;
+        }
+        }
+
+        sink.OnExecutionReport(command.sessionId_, report);
+    };
+
+    // A cancel or amend taken from the priority lane may have overtaken the
+    // add for its own order. If the book has never accepted that id, the adds
+    // queued before it run first; a known id, resting or not, needs no wait,
+    // so stale cancels keep their priority.
+    auto Target = [](const Command& command) {
+        return command.type_ == CommandType::Replace ? command.replacedOrderId_ : command.orderId_;
+    };
+
+    std::size_t processed = 0;
+    Command command;
+    Command older;
+    while (processed < maxCommands && queue.try_pop(command))
+    {
+        if (command.type_ != CommandType::Add && !book.IsKnownOrderId(Target(command))) {
+            while (queue.try_pop_older(older)) {
+                ++processed;
+                Execute(older);
+            }
+        }
+        ++processed;
+        Execute(command);
+    }
+    return processed;
+}
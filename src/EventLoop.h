@@ -0,0 +1,185 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#include <x86intrin.h>
+#endif
+
+inline std::uint64_t ReadCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline void CpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// How an idle loop backs off. Each stage lasts the given number of empty
+// polls before moving to the next; after the yield stage the loop sleeps on a
+// futex until a producer calls Waker::Notify, unless sleep is disabled.
+struct BackoffPolicy
+{
+    std::uint32_t spinIterations_ = 1000;
+    std::uint32_t pauseIterations_ = 10000;
+    std::uint32_t yieldIterations_ = 100;
+    bool sleep_ = true;
+
+    static BackoffPolicy Spin() { return { ~0u, 0, 0, false }; }
+    static BackoffPolicy Pause() { return { 0, ~0u, 0, false }; }
+    static BackoffPolicy Yield() { return { 0, 0, ~0u, false }; }
+    static BackoffPolicy Sleep() { return { 0, 0, 0, true }; }
+};
+
+struct EventLoopStats
+{
+    std::uint64_t busyCycles_ = 0;
+    std::uint64_t idleCycles_ = 0;
+    std::uint64_t busyPolls_ = 0;
+    std::uint64_t idlePolls_ = 0;
+    std::uint64_t pauses_ = 0;
+    std::uint64_t yields_ = 0;
+    std::uint64_t sleeps_ = 0;
+
+    double BusyFraction() const
+    {
+        const std::uint64_t total = busyCycles_ + idleCycles_;
+        return total ? static_cast<double>(busyCycles_) / static_cast<double>(total) : 0.0;
+    }
+};
+
+// Futex-backed wakeup for a sleeping event loop. Producers call Notify after
+// publishing work; it only enters the kernel when the loop is asleep.
+class Waker
+{
+public:
+    void Notify()
+    {
+        sequence_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst))
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&sequence_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+private:
+    friend class EventLoop;
+
+    std::uint32_t Prepare()
+    {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        return sequence_.load(std::memory_order_seq_cst);
+    }
+
+    void Wait(std::uint32_t observed)
+    {
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&sequence_), FUTEX_WAIT_PRIVATE, observed, nullptr, nullptr, 0);
+    }
+
+    void Finish() { sleepers_.fetch_sub(1, std::memory_order_relaxed); }
+
+    alignas(64) std::atomic<std::uint32_t> sequence_{ 0 };
+    std::atomic<std::uint32_t> sleepers_{ 0 };
+};
+
+// Drives a poll function (typically BookEngine::Poll or a DrainIngress call)
+// on a dedicated thread. Polls that return non-zero reset the backoff; empty
+// polls walk through spin, pause, yield and futex sleep as configured. Time
+// spent is split into busy and idle cycles.
+class EventLoop
+{
+public:
+    EventLoop(BackoffPolicy policy, Waker& waker)
+        : policy_{ policy }
+        , waker_{ waker }
+    {}
+
+    template<typename PollFunction>
+    void Run(PollFunction&& poll)
+    {
+        std::uint64_t idleStreak = 0;
+        std::uint64_t last = ReadCycles();
+
+        while (running_.load(std::memory_order_relaxed))
+        {
+            const std::size_t work = poll();
+            const std::uint64_t now = ReadCycles();
+
+            if (work) {
+                stats_.busyCycles_ += now - last;
+                ++stats_.busyPolls_;
+                idleStreak = 0;
+                last = now;
+                continue;
+            }
+
+            ++stats_.idlePolls_;
+            if (Backoff(idleStreak++, poll)) idleStreak = 0;
+            const std::uint64_t after = ReadCycles();
+            stats_.idleCycles_ += after - last;
+            last = after;
+        }
+    }
+
+    void Stop()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        waker_.Notify();
+    }
+
+    const BackoffPolicy& Policy() const { return policy_; }
+    const EventLoopStats& Stats() const { return stats_; }
+
+private:
+    // Returns true if the last-chance poll before sleeping found work.
+    template<typename PollFunction>
+    bool Backoff(std::uint64_t idleStreak, PollFunction& poll)
+    {
+        std::uint64_t stage = policy_.spinIterations_;
+        if (idleStreak < stage) return false;
+
+        stage += policy_.pauseIterations_;
+        if (idleStreak < stage) {
+            CpuRelax();
+            ++stats_.pauses_;
+            return false;
+        }
+
+        stage += policy_.yieldIterations_;
+        if (idleStreak < stage || !policy_.sleep_) {
+            std::this_thread::yield();
+            ++stats_.yields_;
+            return false;
+        }
+
+        // Register as a sleeper before the final poll so a Notify racing with
+        // it either bumps the sequence we wait on or sees us registered.
+        const std::uint32_t observed = waker_.Prepare();
+        const bool found = !running_.load(std::memory_order_relaxed) || poll() != 0;
+        if (!found) {
+            waker_.Wait(observed);
+            ++stats_.sleeps_;
+        }
+        waker_.Finish();
+        return found;
+    }
+
+    BackoffPolicy policy_;
+    Waker& waker_;
+    std::atomic<bool> running_{ true };
+    EventLoopStats stats_;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+#include "Types.h"
+
+enum class OrderStatus : std::uint8_t
+{
+    New,
+    PartiallyFilled,
+    Filled,
+    Killed,
+    Cancelled,
+    Rejected
+};
+
+// Outcome of one book operation for the order it addressed. Small and
+// trivially copyable so it comes back in registers rather than memory.
+// Cancels and amends that succeed also give the side and price of the level
+// the order left, so a caller publishing depth need not look it up first.
+struct ExecutionReport
+{
+    Quantity filledQuantity_ = 0;
+    Quantity remainingQuantity_ = 0;
+    OrderStatus status_ = OrderStatus::New;
+    ErrorCode rejectReason_ = ErrorCode::None;
+    bool resting_ = false;
+    Side fromSide_ = Side::Buy;
+    Price fromPrice_ = 0;
+
+    bool IsRejected() const { return status_ == OrderStatus::Rejected; }
+
+    static ExecutionReport Rejected(ErrorCode reason)
+    {
+        return ExecutionReport{ 0, 0, OrderStatus::Rejected, reason, false };
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<ExecutionReport>);
+static_assert(sizeof(ExecutionReport) <= 16, "ExecutionReport must fit in two registers");
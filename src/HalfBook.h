@@ -0,0 +1,384 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <bit>
+#include <limits>
+#include <functional>
+
+#include "Types.h"
+#include "Order.h"
+#include "OrderList.h"
+
+// Compile-time description of one side of the book: price ordering, the
+// sentinel an empty side reports as its best price, and the cross test
+// against an incoming order from the other side.
+template<Side S>
+struct SideTraits;
+
+template<>
+struct SideTraits<Side::Buy>
+{
+    using Compare = std::greater<Price>;
+    static constexpr Side Opposite = Side::Sell;
+    static constexpr Price EmptyBest = std::numeric_limits<Price>::min();
+
+    // Does a sell at incoming trade against a best bid of best?
+    static bool Crosses(Price best, Price incoming) { return incoming <= best; }
+};
+
+template<>
+struct SideTraits<Side::Sell>
+{
+    using Compare = std::less<Price>;
+    static constexpr Side Opposite = Side::Buy;
+    static constexpr Price EmptyBest = std::numeric_limits<Price>::max();
+
+    // Does a buy at incoming trade against a best ask of best?
+    static bool Crosses(Price best, Price incoming) { return incoming >= best; }
+};
+
+// One side of the book: price levels ordered best-first, each a FIFO of
+// resting orders. All side-dependent behaviour is resolved at compile time.
+//
+// Levels near the best price live in a dense window of a power-of-two number
+// of ticks, so the hot band needs no tree access. Levels behind the window,
+// typically stale orders far from the market, go to a sparse ordered map.
+// The window starts a quarter of its width ahead of the best price and is
+// moved when an order improves on it or the best price falls deep into it.
+// Every sparse level is worse than every window level.
+//
+// The window is circular: a level's slot is its price key masked to the
+// window size, and the window is the key range [windowStart_, WindowEnd()).
+// It starts at InitialWindowTicks on the first add and doubles, up to the
+// configured width, when an order lands behind it within that width; a
+// book quoted only near the touch keeps a small window.
+// Moving it only advances those watermarks, evicting levels from the ticks it
+// leaves to the sparse store and pulling in sparse levels for the ticks it
+// enters, so the cost is proportional to the ticks moved and levels that stay
+// in the window are never copied.
+template<Side S>
+class HalfBook
+{
+public:
+    using Traits = SideTraits<S>;
+    using SparseLevels = std::map<Price, OrderList, typename Traits::Compare>;
+
+    static constexpr std::size_t DefaultWindowTicks = 256;
+    static constexpr std::size_t InitialWindowTicks = 16;
+
+    // Emptied sparse levels keep their tree node on a short free list, so a
+    // price that empties and refills reuses it instead of going back to the
+    // allocator.
+    static constexpr std::size_t MaxSpareLevels = 64;
+
+    HalfBook(OrderList::Pool& pool, OrderList::ChunkPool& chunks, std::size_t windowTicks = DefaultWindowTicks)
+        : pool_{ pool }
+        , chunks_{ chunks }
+        , windowTicks_{ std::bit_ceil(std::max<std::size_t>(windowTicks, 4)) }
+    {}
+
+    bool empty() const { return best_ == nullptr; }
+    std::size_t size() const { return windowLevels_ + sparse_.size(); }
+
+    // The best level is cached and only refreshed when the top of this side
+    // changes. An empty half reports a price that no incoming order can cross.
+    Price BestPrice() const { return bestPrice_; }
+    bool IsCrossedBy(Price incoming) const { return Traits::Crosses(bestPrice_, incoming); }
+    Quantity BestQuantity() const { return best_ ? best_->quantity() : 0; }
+
+    OrderList& BestLevel() { return *best_; }
+    const OrderList& BestLevel() const { return *best_; }
+
+    // Drops the best level once matching has emptied it.
+    void PopBestLevel()
+    {
+        if (!InWindow(bestPrice_)) {
+            ++sparseOperations_;
+            Retire(sparse_.begin());
+        } else {
+            --windowLevels_;
+        }
+        RefreshBest();
+    }
+
+    void Add(OrderHandle handle)
+    {
+        const Price price = pool_[handle].GetPrice();
+        if (window_.empty()) [[unlikely]] {
+            window_.resize(std::min(windowTicks_, InitialWindowTicks));
+            mask_ = window_.size() - 1;
+            windowStart_ = Key(price) - Lead();
+        } else if (!best_) [[unlikely]] {
+            windowStart_ = Key(price) - Lead();
+        } else if (Key(price) < windowStart_) [[unlikely]] {
+            // Grow first when the levels behind would otherwise slide out of
+            // a window still short of its full width.
+            const std::size_t span = static_cast<std::size_t>(WindowEnd() - Key(price));
+            if (windowLevels_ && window_.size() < windowTicks_)
+                GrowWindow(std::min(windowTicks_, std::bit_ceil(2 * span)));
+            MoveWindow(Key(price) - Lead());
+        } else if (Key(price) >= WindowEnd() && Key(price) - windowStart_ < static_cast<std::int64_t>(windowTicks_)) [[unlikely]] {
+            GrowWindow(std::bit_ceil(static_cast<std::size_t>(Key(price) - windowStart_ + 1)));
+        }
+
+        OrderList* level;
+        if (InWindow(price)) [[likely]] {
+            level = &Slot(price);
+            if (level->empty()) ++windowLevels_;
+        } else {
+            ++sparseOperations_;
+            level = &SparseLevel(price);
+        }
+        level->push_back(pool_, chunks_, handle);
+
+        if (!best_ || Key(price) < Key(bestPrice_)) {
+            best_ = level;
+            bestPrice_ = price;
+        }
+    }
+
+    void Remove(OrderHandle handle)
+    {
+        const Price price = pool_[handle].GetPrice();
+        if (InWindow(price)) [[likely]] {
+            OrderList& level = Slot(price);
+            level.remove(pool_, chunks_, handle);
+            if (!level.empty()) return;
+            --windowLevels_;
+        } else {
+            ++sparseOperations_;
+            auto it = sparse_.find(price);
+            it->second.remove(pool_, chunks_, handle);
+            if (!it->second.empty()) return;
+            Retire(it);
+        }
+
+        if (price == bestPrice_) RefreshBest();
+    }
+
+    // Batch form of Remove: a level the removal empties stays where it is
+    // until SweepEmptyLevels, so a batch erases each sparse level and looks
+    // for a new best price once rather than per order. Nothing but further
+    // deferred removals may touch this side until the sweep.
+    void RemoveDeferred(OrderHandle handle)
+    {
+        const Price price = pool_[handle].GetPrice();
+        if (InWindow(price)) [[likely]] {
+            OrderList& level = Slot(price);
+            level.remove(pool_, chunks_, handle);
+            if (!level.empty()) return;
+            --windowLevels_;
+        } else {
+            ++sparseOperations_;
+            auto it = sparse_.find(price);
+            it->second.remove(pool_, chunks_, handle);
+            if (!it->second.empty()) return;
+            emptiedLevels_.push_back(it);
+        }
+
+        if (price == bestPrice_) bestEmptied_ = true;
+    }
+
+    void SweepEmptyLevels()
+    {
+        for (auto it : emptiedLevels_) Retire(it);
+        emptiedLevels_.clear();
+        if (bestEmptied_) RefreshBest();
+        bestEmptied_ = false;
+    }
+
+    // Changes a resting order's open quantity without leaving its level; see
+    // OrderList::requote. The quantity must not be zero.
+    void Requote(OrderHandle handle, Quantity quantity)
+    {
+        const Price price = pool_[handle].GetPrice();
+        if (InWindow(price)) [[likely]] {
+            Slot(price).requote(pool_, chunks_, handle, quantity);
+        } else {
+            ++sparseOperations_;
+            sparse_.find(price)->second.requote(pool_, chunks_, handle, quantity);
+        }
+    }
+
+    Quantity LevelQuantity(Price price) const
+    {
+        if (InWindow(price)) return Slot(price).quantity();
+        auto it = sparse_.find(price);
+        return it == sparse_.end() ? 0 : it->second.quantity();
+    }
+
+    // Calls visit(price, level) for every level, best first.
+    template<typename Visitor>
+    void ForEachLevel(Visitor&& visit) const
+    {
+        if (windowLevels_)
+            for (std::int64_t key = windowStart_; key < WindowEnd(); ++key)
+                if (!SlotAt(key).empty()) visit(PriceOf(key), SlotAt(key));
+        for (const auto& [price, level] : sparse_) visit(price, level);
+    }
+
+    std::size_t SpareLevels() const { return spareLevels_.size(); }
+
+    // Adds, removals and pops that went to the sparse store, and levels moved
+    // between the stores when the window moved.
+    std::uint64_t SparseOperations() const { return sparseOperations_; }
+    std::uint64_t Migrations() const { return migrations_; }
+
+    // Bytes held by the window and by live and spare sparse levels. Tree
+    // nodes are estimated as the value plus the parent/left/right links and
+    // colour of a red-black node.
+    std::size_t MemoryUsage() const
+    {
+        constexpr std::size_t NodeSize = sizeof(typename SparseLevels::value_type) + 4 * sizeof(void*);
+        return window_.capacity() * sizeof(OrderList)
+            + (sparse_.size() + spareLevels_.size()) * NodeSize
+            + spareLevels_.capacity() * sizeof(typename SparseLevels::node_type);
+    }
+
+private:
+    // Position on this side with better prices first: the price for asks and
+    // its negation for bids.
+    static std::int64_t Key(Price price)
+    {
+        if constexpr (S == Side::Buy) return -static_cast<std::int64_t>(price);
+        else return price;
+    }
+
+    static Price PriceOf(std::int64_t key)
+    {
+        if constexpr (S == Side::Buy) return static_cast<Price>(-key);
+        else return static_cast<Price>(key);
+    }
+
+    std::int64_t Lead() const { return static_cast<std::int64_t>(window_.size() / 4); }
+    std::int64_t WindowEnd() const { return windowStart_ + static_cast<std::int64_t>(window_.size()); }
+
+    bool InWindow(Price price) const
+    {
+        return static_cast<std::uint64_t>(Key(price) - windowStart_) < window_.size();
+    }
+
+    OrderList& SlotAt(std::int64_t key) { return window_[static_cast<std::uint64_t>(key) & mask_]; }
+    const OrderList& SlotAt(std::int64_t key) const { return window_[static_cast<std::uint64_t>(key) & mask_]; }
+    OrderList& Slot(Price price) { return SlotAt(Key(price)); }
+    const OrderList& Slot(Price price) const { return SlotAt(Key(price)); }
+
+    OrderList& SparseLevel(Price price)
+    {
+        auto it = sparse_.lower_bound(price);
+        if (it == sparse_.end() || it->first != price) {
+            if (spareLevels_.empty()) {
+                it = sparse_.emplace_hint(it, price, OrderList{});
+            } else {
+                typename SparseLevels::node_type node = std::move(spareLevels_.back());
+                spareLevels_.pop_back();
+                node.key() = price;
+                it = sparse_.insert(it, std::move(node));
+            }
+        }
+        return it->second;
+    }
+
+    void Retire(typename SparseLevels::iterator it)
+    {
+        it->second = OrderList{};
+        if (spareLevels_.size() < MaxSpareLevels) spareLevels_.push_back(sparse_.extract(it));
+        else sparse_.erase(it);
+    }
+
+    // Moves the window to start at start. Levels on the ticks it leaves go to
+    // the sparse store; sparse levels on the ticks it enters come in. Nothing
+    // is better than start, so when moving towards worse prices the ticks
+    // left behind are already empty.
+    void MoveWindow(std::int64_t start)
+    {
+        const std::int64_t oldStart = windowStart_;
+        const std::int64_t oldEnd = WindowEnd();
+        const std::int64_t end = start + static_cast<std::int64_t>(window_.size());
+
+        // Keys of the old window that the new one no longer covers: all of
+        // them when the move is a full window or more.
+        const std::int64_t evictFrom = start < oldStart ? std::max(end, oldStart) : oldStart;
+        const std::int64_t evictTo = start < oldStart ? oldEnd : std::min(start, oldEnd);
+        for (std::int64_t key = evictFrom; key < evictTo && windowLevels_; ++key)
+        {
+            OrderList& level = SlotAt(key);
+            if (level.empty()) continue;
+            SparseLevel(PriceOf(key)) = level;
+            level = OrderList{};
+            --windowLevels_;
+            ++migrations_;
+        }
+        windowStart_ = start;
+        PullSparseLevels();
+    }
+
+    // Grows the window to ticks, keeping its start. Levels keep
+    // their keys and move to their slots in the wider ring, and sparse levels
+    // on the ticks it now covers come in.
+    void GrowWindow(std::size_t ticks)
+    {
+        std::vector<OrderList> window(ticks);
+        const std::size_t mask = ticks - 1;
+        if (windowLevels_)
+            for (std::int64_t key = windowStart_; key < WindowEnd(); ++key)
+                window[static_cast<std::uint64_t>(key) & mask] = SlotAt(key);
+        window_.swap(window);
+        mask_ = mask;
+        PullSparseLevels();
+        if (best_) best_ = &Slot(bestPrice_);
+    }
+
+    void PullSparseLevels()
+    {
+        while (!sparse_.empty() && Key(sparse_.begin()->first) < WindowEnd())
+        {
+            Slot(sparse_.begin()->first) = sparse_.begin()->second;
+            ++windowLevels_;
+            ++migrations_;
+            Retire(sparse_.begin());
+        }
+    }
+
+    // Finds the new best level after the old one emptied, scanning forward in
+    // the window from the old best. Pulls the window along when the best has
+    // moved deep into it or out of it.
+    void RefreshBest()
+    {
+        if (windowLevels_) {
+            std::int64_t key = std::max(Key(bestPrice_), windowStart_);
+            while (SlotAt(key).empty()) ++key;
+            bestPrice_ = PriceOf(key);
+            if (key - windowStart_ > static_cast<std::int64_t>(window_.size() / 2)) MoveWindow(key - Lead());
+            best_ = &SlotAt(key);
+            return;
+        }
+
+        if (sparse_.empty()) {
+            best_ = nullptr;
+            bestPrice_ = Traits::EmptyBest;
+            return;
+        }
+
+        bestPrice_ = sparse_.begin()->first;
+        MoveWindow(Key(bestPrice_) - Lead());
+        best_ = &Slot(bestPrice_);
+    }
+
+    OrderList::Pool& pool_;
+    OrderList::ChunkPool& chunks_;
+    std::size_t windowTicks_;
+    std::size_t mask_ = 0;
+    std::vector<OrderList> window_;
+    std::int64_t windowStart_ = 0;
+    std::size_t windowLevels_ = 0;
+    SparseLevels sparse_;
+    std::vector<typename SparseLevels::node_type> spareLevels_;
+    std::vector<typename SparseLevels::iterator> emptiedLevels_;
+    bool bestEmptied_ = false;
+    OrderList* best_ = nullptr;
+    Price bestPrice_ = Traits::EmptyBest;
+    std::uint64_t sparseOperations_ = 0;
+    std::uint64_t migrations_ = 0;
+};
@@ -0,0 +1,221 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Types.h"
+
+enum class CommandType : std::uint8_t
+{
+    Add,
+    Cancel,
+    Modify,
+    Replace
+};
+
+// A single request for the book, tagged with the session that sent it so the
+// dispatcher can route execution reports back.
+struct Command
+{
+    CommandType type_;
+    OrderType orderType_;
+    Side side_;
+    std::uint32_t sessionId_;
+    OrderId orderId_;
+    Price price_;
+    Quantity quantity_;
+    OrderId replacedOrderId_;
+};
+
+// Lanes of the ingress queue. Cancels and amends travel in the priority lane
+// so that a burst of new orders cannot delay them.
+enum class IngressLane : std::uint8_t
+{
+    Priority,
+    Order
+};
+
+// Per-lane counters, updated by the consumer as it pops. Depth is the backlog
+// the consumer saw behind each pop. Latency runs from try_push to try_pop and,
+// as reading the clock costs about as much as a cancel, is sampled on one
+// command in IngressQueue::LatencySampleInterval.
+struct IngressLaneStats
+{
+    std::uint64_t commands_ = 0;
+    std::uint64_t latencySamples_ = 0;
+    std::uint64_t totalLatencyNs_ = 0;
+    std::uint64_t maxLatencyNs_ = 0;
+    std::size_t maxDepth_ = 0;
+
+    double MeanLatencyNs() const { return latencySamples_ ? static_cast<double>(totalLatencyNs_) / static_cast<double>(latencySamples_) : 0.0; }
+};
+
+// Single-producer/single-consumer queue in front of an OrderBook, made of two
+// rings: cancels, modifies and replaces go to the priority lane, adds to the
+// order lane. The consumer drains the priority lane first but takes an add
+// after fairnessWindow priority commands in a row, so adds are never starved.
+// A fairness window of 0 turns the lanes off: every command then goes through
+// the order lane in arrival order. Each lane holds capacity commands, rounded
+// up to a power of two so indices wrap with a mask.
+//
+// Commands are stamped with a sequence number on push. A priority command
+// may overtake the add for the very order it targets; try_pop_older lets the
+// consumer run the adds queued before it first.
+class IngressQueue
+{
+public:
+    static constexpr std::size_t DefaultFairnessWindow = 16;
+    static constexpr std::uint64_t LatencySampleInterval = 64;
+
+    explicit IngressQueue(std::size_t capacity, std::size_t fairnessWindow = DefaultFairnessWindow)
+        : lanes_{ Ring{ capacity }, Ring{ capacity } }
+        , fairnessWindow_{ fairnessWindow }
+    {}
+
+    static IngressLane LaneOf(CommandType type) { return type == CommandType::Add ? IngressLane::Order : IngressLane::Priority; }
+
+    bool try_push(const Command& command)
+    {
+        const IngressLane lane = fairnessWindow_ ? LaneOf(command.type_) : IngressLane::Order;
+        const std::uint64_t enqueuedNs = sequence_ % LatencySampleInterval ? 0 : NowNs();
+        if (!Lane(lane).try_push(command, sequence_, enqueuedNs)) return false;
+        ++sequence_;
+        return true;
+    }
+
+    bool try_pop(Command& command)
+    {
+        if (priorityRun_ < fairnessWindow_ && Pop(IngressLane::Priority, command)) {
+            ++priorityRun_;
+            return true;
+        }
+        priorityRun_ = 0;
+        if (Pop(IngressLane::Order, command)) return true;
+        if (!Pop(IngressLane::Priority, command)) return false;
+        priorityRun_ = 1;
+        return true;
+    }
+
+    // Pops the oldest queued add if it was pushed before the command last
+    // returned by try_pop.
+    bool try_pop_older(Command& command)
+    {
+        const std::uint64_t sequence = lastSequence_;
+        const Ring::Entry* entry = Lane(IngressLane::Order).front();
+        if (!entry || entry->sequence_ >= sequence) return false;
+        Pop(IngressLane::Order, command);
+        lastSequence_ = sequence;
+        return true;
+    }
+
+    bool empty() const { return lanes_[0].empty() && lanes_[1].empty(); }
+    std::size_t size() const { return lanes_[0].size() + lanes_[1].size(); }
+    std::size_t capacity() const { return lanes_[0].capacity() + lanes_[1].capacity(); }
+
+    std::size_t Depth(IngressLane lane) const { return Lane(lane).size(); }
+    const IngressLaneStats& Stats(IngressLane lane) const { return stats_[static_cast<std::size_t>(lane)]; }
+
+private:
+    static std::uint64_t NowNs()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    class Ring
+    {
+    public:
+        struct Entry
+        {
+            Command command_;
+            std::uint64_t sequence_;
+            std::uint64_t enqueuedNs_;
+        };
+
+        explicit Ring(std::size_t capacity)
+        {
+            std::size_t size = 1;
+            while (size < capacity) size <<= 1;
+            buffer_.resize(size);
+            mask_ = size - 1;
+        }
+
+        bool try_push(const Command& command, std::uint64_t sequence, std::uint64_t nowNs)
+        {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cachedHead_ > mask_) {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                if (tail - cachedHead_ > mask_) return false;
+            }
+            buffer_[tail & mask_] = Entry{ command, sequence, nowNs };
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        const Entry* front()
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cachedTail_) {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_) return nullptr;
+            }
+            return &buffer_[head & mask_];
+        }
+
+        // Backlog behind the front entry as of the last refresh of the tail.
+        std::size_t behind() const { return cachedTail_ - head_.load(std::memory_order_relaxed) - 1; }
+
+        void pop_front() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+        bool empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+        std::size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+        std::size_t capacity() const { return mask_ + 1; }
+
+    private:
+        std::vector<Entry> buffer_;
+        std::size_t mask_ = 0;
+
+        alignas(64) std::atomic<std::size_t> head_{ 0 };
+        std::size_t cachedTail_ = 0;
+
+        alignas(64) std::atomic<std::size_t> tail_{ 0 };
+        std::size_t cachedHead_ = 0;
+    };
+
+    Ring& Lane(IngressLane lane) { return lanes_[static_cast<std::size_t>(lane)]; }
+    const Ring& Lane(IngressLane lane) const { return lanes_[static_cast<std::size_t>(lane)]; }
+
+    bool Pop(IngressLane lane, Command& command)
+    {
+        Ring& ring = Lane(lane);
+        const Ring::Entry* entry = ring.front();
+        if (!entry) return false;
+        IngressLaneStats& stats = stats_[static_cast<std::size_t>(lane)];
+        ++stats.commands_;
+        if (entry->enqueuedNs_) {
+            const std::uint64_t latencyNs = NowNs() - entry->enqueuedNs_;
+            ++stats.latencySamples_;
+            stats.totalLatencyNs_ += latencyNs;
+            stats.maxLatencyNs_ = std::max(stats.maxLatencyNs_, latencyNs);
+        }
+        stats.maxDepth_ = std::max(stats.maxDepth_, ring.behind());
+        command = entry->command_;
+        lastSequence_ = entry->sequence_;
+        ring.pop_front();
+        return true;
+    }
+
+    Ring lanes_[2];
+    std::size_t fairnessWindow_;
+
+    // Consumer side.
+    std::size_t priorityRun_ = 0;
+    std::uint64_t lastSequence_ = 0;
+    IngressLaneStats stats_[2];
+
+    // Producer side.
+    alignas(64) std::uint64_t sequence_ = 0;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "Types.h"
+
+// Market data wire format. A datagram is a PacketHeader followed by
+// messageCount_ fixed-size BookDeltas. Every delta carries its own sequence
+// number, sequence_ + i, so consumers can detect gaps at message granularity.
+namespace MarketData
+{
+    constexpr std::size_t MaxDatagramSize = 1472; // 1500-byte Ethernet MTU minus IPv4 and UDP headers
+
+    enum class DeltaType : std::uint8_t
+    {
+        Level = 'L',
+        Trade = 'T'
+    };
+
+#pragma pack(push, 1)
+    struct PacketHeader
+    {
+        std::uint64_t sequence_;
+        std::uint16_t messageCount_;
+        std::uint16_t reserved_;
+        std::uint32_t channel_;
+        std::uint64_t sendTimeNs_;
+    };
+
+    // Level: quantity_ is the new aggregate quantity at (side_, price_), zero
+    // when the level is gone. Trade: side_ is the aggressor side.
+    struct BookDelta
+    {
+        DeltaType type_;
+        std::uint8_t side_;
+        std::uint16_t reserved_;
+        Price price_;
+        Quantity quantity_;
+        std::uint64_t eventTimeNs_;
+    };
+
+    // Recovery channel: a snapshot is split over fragmentCount_ datagrams, each
+    // a PacketHeader, a SnapshotHeader and messageCount_ SnapshotLevels. The
+    // PacketHeader's sequence_ is the first delta sequence NOT reflected in the
+    // snapshot, so consumers apply buffered deltas from there on.
+    struct SnapshotHeader
+    {
+        std::uint32_t snapshotId_;
+        std::uint16_t fragmentIndex_;
+        std::uint16_t fragmentCount_;
+    };
+
+    struct SnapshotLevel
+    {
+        std::uint8_t side_;
+        Price price_;
+        Quantity quantity_;
+    };
+#pragma pack(pop)
+
+    constexpr std::size_t MaxDeltasPerPacket = (MaxDatagramSize - sizeof(PacketHeader)) / sizeof(BookDelta);
+    constexpr std::size_t MaxLevelsPerPacket = (MaxDatagramSize - sizeof(PacketHeader) - sizeof(SnapshotHeader)) / sizeof(SnapshotLevel);
+
+    inline std::uint64_t NowNs()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
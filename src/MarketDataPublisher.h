@@ -0,0 +1,160 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "MarketData.h"
+#include "Transport.h"
+#include "OrderBook.h"
+
+struct PublisherStats
+{
+    std::uint64_t deltas_ = 0;
+    std::uint64_t packets_ = 0;
+    std::uint64_t batches_ = 0;
+    std::uint64_t bytes_ = 0;
+    std::uint64_t sendErrors_ = 0;
+    std::uint64_t latencySumNs_ = 0; // event time to transport send, summed over deltas
+    std::uint64_t latencyMaxNs_ = 0;
+};
+
+// Packs book deltas into MTU-sized datagrams and hands completed datagrams to
+// the transport in bursts of up to BatchSize (one sendmmsg on UdpTransport).
+class MarketDataPublisher
+{
+public:
+    static constexpr std::size_t BatchSize = 32;
+
+    explicit MarketDataPublisher(Transport& transport, std::uint32_t channel = 0)
+        : transport_{ transport }
+        , channel_{ channel }
+    {
+        eventTimes_.reserve(BatchSize * MarketData::MaxDeltasPerPacket);
+        Reset(0);
+    }
+
+    MarketDataPublisher(const MarketDataPublisher&) = delete;
+    MarketDataPublisher& operator=(const MarketDataPublisher&) = delete;
+
+    void PublishLevel(Side side, Price price, Quantity quantity, std::uint64_t eventTimeNs)
+    {
+        Append(MarketData::BookDelta{ MarketData::DeltaType::Level, static_cast<std::uint8_t>(side), 0, price, quantity, eventTimeNs });
+    }
+
+    void PublishTrade(Side aggressor, Price price, Quantity quantity, std::uint64_t eventTimeNs)
+    {
+        Append(MarketData::BookDelta{ MarketData::DeltaType::Trade, static_cast<std::uint8_t>(aggressor), 0, price, quantity, eventTimeNs });
+    }
+
+    // Publishes the effect of an AddOrder/MatchOrder call: one trade delta per
+    // trade, then the new aggregate of every level the call touched.
+    void PublishAdd(const OrderBook& book, Side side, Price price, const Trades& trades, std::uint64_t eventTimeNs)
+    {
+        touched_.clear();
+        touched_.push_back(price);
+        const Side contra = side == Side::Buy ? Side::Sell : Side::Buy;
+
+        for (const auto& trade : trades)
+        {
+            const TradeInfo& passive = side == Side::Buy ? trade.GetAskTrade() : trade.GetBidTrade();
+            PublishTrade(side, passive.price_, passive.quantity_, eventTimeNs);
+            if (std::find(touched_.begin() + 1, touched_.end(), passive.price_) == touched_.end())
+                touched_.push_back(passive.price_);
+        }
+
+        PublishLevel(side, price, book.GetLevelQuantity(side, price), eventTimeNs);
+        for (std::size_t i = 1; i < touched_.size(); ++i)
+            PublishLevel(contra, touched_[i], book.GetLevelQuantity(contra, touched_[i]), eventTimeNs);
+    }
+
+    // Sends every pending datagram, including the partially filled one.
+    void Flush()
+    {
+        if (packetSizes_[current_] > sizeof(MarketData::PacketHeader)) Close();
+        Send();
+    }
+
+    std::uint64_t NextSequence() const { return nextSequence_; }
+    const PublisherStats& Stats() const { return stats_; }
+
+private:
+    using Datagram = std::array<char, MarketData::MaxDatagramSize>;
+
+    MarketData::PacketHeader& Header(std::size_t index)
+    {
+        return *reinterpret_cast<MarketData::PacketHeader*>(packets_[index].data());
+    }
+
+    void Reset(std::size_t index)
+    {
+        MarketData::PacketHeader& header = Header(index);
+        header.sequence_ = nextSequence_;
+        header.messageCount_ = 0;
+        header.reserved_ = 0;
+        header.channel_ = channel_;
+        header.sendTimeNs_ = 0;
+        packetSizes_[index] = sizeof(MarketData::PacketHeader);
+    }
+
+    void Append(const MarketData::BookDelta& delta)
+    {
+        if (packetSizes_[current_] + sizeof(delta) > MarketData::MaxDatagramSize) Close();
+
+        std::memcpy(packets_[current_].data() + packetSizes_[current_], &delta, sizeof(delta));
+        packetSizes_[current_] += sizeof(delta);
+        ++Header(current_).messageCount_;
+        eventTimes_.push_back(delta.eventTimeNs_);
+        ++nextSequence_;
+        ++stats_.deltas_;
+    }
+
+    void Close()
+    {
+        ++current_;
+        if (current_ == BatchSize) Send();
+        else Reset(current_);
+    }
+
+    void Send()
+    {
+        if (current_ == 0) return;
+
+        const std::uint64_t now = MarketData::NowNs();
+        std::array<Frame, BatchSize> frames;
+        for (std::size_t i = 0; i < current_; ++i)
+        {
+            Header(i).sendTimeNs_ = now;
+            frames[i] = Frame{ packets_[i].data(), packetSizes_[i] };
+        }
+
+        const std::size_t sent = transport_.Send(std::span<const Frame>{ frames.data(), current_ });
+        for (std::size_t i = 0; i < sent; ++i) stats_.bytes_ += packetSizes_[i];
+        stats_.sendErrors_ += current_ - sent;
+
+        stats_.packets_ += sent;
+        ++stats_.batches_;
+        for (auto eventTime : eventTimes_)
+        {
+            const std::uint64_t latency = now - eventTime;
+            stats_.latencySumNs_ += latency;
+            stats_.latencyMaxNs_ = std::max(stats_.latencyMaxNs_, latency);
+        }
+        eventTimes_.clear();
+
+        current_ = 0;
+        Reset(0);
+    }
+
+    Transport& transport_;
+    std::uint32_t channel_;
+    std::uint64_t nextSequence_ = 1;
+
+    std::array<Datagram, BatchSize> packets_;
+    std::array<std::size_t, BatchSize> packetSizes_{};
+    std::size_t current_ = 0;
+
+    std::vector<std::uint64_t> eventTimes_;
+    std::vector<Price> touched_;
+    PublisherStats stats_;
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "MarketData.h"
+#include "Transport.h"
+
+struct ReceiverStats
+{
+    std::uint64_t packets_ = 0;
+    std::uint64_t deltas_ = 0;
+    std::uint64_t gaps_ = 0;
+    std::uint64_t missedDeltas_ = 0;
+    std::uint64_t staleDeltas_ = 0;
+    std::uint64_t latencySumNs_ = 0; // event time to receipt, summed over deltas
+    std::uint64_t latencyMaxNs_ = 0;
+};
+
+// Consumer of the market data feed. Datagrams are read from the transport in
+// bursts and checked against the expected sequence number; a jump forward is
+// recorded as a gap, anything older is dropped as stale.
+class MarketDataReceiver
+{
+public:
+    static constexpr std::size_t BatchSize = 32;
+
+    explicit MarketDataReceiver(Transport& transport)
+        : transport_{ transport }
+    {}
+
+    // Reads whatever is available and calls handler(sequence, delta) for each
+    // in-order delta. Returns the number of datagrams read.
+    template<typename Handler>
+    std::size_t Poll(Handler&& handler)
+    {
+        return PollDatagrams([this, &handler](const char* data, std::size_t length, std::uint64_t now) {
+            OnDatagram(data, length, now, handler);
+        });
+    }
+
+    // Hands each datagram to handler(data, length, receiveTimeNs) without
+    // interpreting it; used for channels that are not a delta feed.
+    template<typename Handler>
+    std::size_t PollDatagrams(Handler&& handler)
+    {
+        std::array<Frame, BatchSize> frames;
+        const std::size_t received = transport_.Receive(frames);
+        if (!received) return 0;
+
+        const std::uint64_t now = MarketData::NowNs();
+        for (std::size_t i = 0; i < received; ++i)
+            handler(frames[i].data_, frames[i].length_, now);
+        return received;
+    }
+
+    std::uint64_t ExpectedSequence() const { return expected_; }
+    const ReceiverStats& Stats() const { return stats_; }
+
+private:
+    template<typename Handler>
+    void OnDatagram(const char* data, std::size_t length, std::uint64_t now, Handler& handler)
+    {
+        using namespace MarketData;
+
+        if (length < sizeof(PacketHeader)) return;
+        PacketHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (sizeof(PacketHeader) + header.messageCount_ * sizeof(BookDelta) > length) return;
+        ++stats_.packets_;
+
+        if (header.sequence_ > expected_) {
+            ++stats_.gaps_;
+            stats_.missedDeltas_ += header.sequence_ - expected_;
+            expected_ = header.sequence_;
+        }
+
+        const char* cursor = data + sizeof(PacketHeader);
+        for (std::uint16_t i = 0; i < header.messageCount_; ++i, cursor += sizeof(BookDelta))
+        {
+            const std::uint64_t sequence = header.sequence_ + i;
+            if (sequence < expected_) {
+                ++stats_.staleDeltas_;
+                continue;
+            }
+
+            BookDelta delta;
+            std::memcpy(&delta, cursor, sizeof(delta));
+            const std::uint64_t latency = now - delta.eventTimeNs_;
+            stats_.latencySumNs_ += latency;
+            stats_.latencyMaxNs_ = std::max(stats_.latencyMaxNs_, latency);
+            ++stats_.deltas_;
+
+            expected_ = sequence + 1;
+            handler(sequence, delta);
+        }
+    }
+
+    Transport& transport_;
+    std::uint64_t expected_ = 1;
+    ReceiverStats stats_;
+};
@@ -1,39 +1,119 @@
 #pragma once
 #include <vector>
-#include <stdexcept>
+#include <cstdint>
 #include <utility>
+#include <algorithm>
+
+// Reference to a pool slot: a 24-bit index and an 8-bit generation. Releasing
+// a slot bumps its generation, so a handle kept past release no longer
+// resolves.
+class PoolHandle {
+public:
+    static constexpr std::uint32_t IndexBits = 24;
+    static constexpr std::uint32_t IndexMask = (1u << IndexBits) - 1;
+
+    constexpr PoolHandle() = default;
+    constexpr PoolHandle(std::uint32_t index, std::uint8_t generation)
+        : value_{ (static_cast<std::uint32_t>(generation) << IndexBits) | (index & IndexMask) } {}
+
+    std::uint32_t Index() const { return value_ & IndexMask; }
+    std::uint8_t Generation() const { return static_cast<std::uint8_t>(value_ >> IndexBits); }
+    bool IsNull() const { return value_ == Null; }
+    explicit operator bool() const { return value_ != Null; }
+
+    friend bool operator==(PoolHandle, PoolHandle) = default;
+
+private:
+    static constexpr std::uint32_t Null = ~0u;
+    std::uint32_t value_ = Null;
+};
 
 template<typename T>
 class ObjectPool {
 private:
+    // The pool starts small and doubles on demand up to max_size(). Growth may
+    // move the objects, which is safe because everything outside the pool
+    // refers to them by handle; pointers from get() or operator[] are only
+    // valid until the next acquire.
+    static constexpr size_t InitialSize = 16;
+
     std::vector<T> pool_;
-    std::vector<size_t> free_indices_;
+    std::vector<std::uint8_t> generations_;
+    std::vector<std::uint32_t> free_indices_;
+    size_t capacity_ = 0;
+    size_t max_size_;
 
-public:
-    ObjectPool(size_t size) {
-        pool_.resize(size);
-        free_indices_.reserve(size);
-        for (size_t i = 0; i < size; ++i) {
-            free_indices_.push_back(i);
+    T& slot(std::uint32_t index) { return pool_[index]; }
+    const T& slot(std::uint32_t index) const { return pool_[index]; }
+
+    bool grow(size_t target = 0) {
+        if (capacity_ >= max_size_) return false;
+        const size_t wanted = std::max({ capacity_, InitialSize, target > capacity_ ? target - capacity_ : 0 });
+        const size_t size = std::min(wanted, max_size_ - capacity_);
+        pool_.resize(capacity_ + size);
+        generations_.resize(capacity_ + size);
+        free_indices_.reserve(capacity_ + size);
+        for (size_t i = capacity_ + size; i-- > capacity_;) {
+            free_indices_.push_back(static_cast<std::uint32_t>(i));
         }
+        capacity_ += size;
+        return true;
+    }
+
+public:
+    // The all-ones index is reserved for the null handle.
+    static constexpr size_t MaxSize = PoolHandle::IndexMask;
+
+    // Allocates nothing until the first acquire or reserve.
+    explicit ObjectPool(size_t maxSize)
+        : max_size_{ std::min(maxSize, MaxSize) } {}
+
+    // Grows until at least size slots exist (capped at max_size()).
+    void reserve(size_t size) {
+        if (capacity_ < size) grow(size);
     }
 
+    // Returns a null handle when the pool is exhausted.
     template<typename... Args>
-    T* acquire(Args&&... args) {
-        if (free_indices_.empty()) {
-            throw std::runtime_error("Pool exhausted! Increase pool size.");
+    PoolHandle acquire(Args&&... args) {
+        if (free_indices_.empty() && !grow()) [[unlikely]] {
+            return PoolHandle{};
         }
 
-        size_t index = free_indices_.back();
+        std::uint32_t index = free_indices_.back();
         free_indices_.pop_back();
 
-        pool_[index] = T(std::forward<Args>(args)...);
-        return &pool_[index];
+        slot(index) = T(std::forward<Args>(args)...);
+        return PoolHandle{ index, generations_[index] };
+    }
+
+    // Returns false, and does nothing, for a stale or foreign handle.
+    bool release(PoolHandle handle) {
+        if (!valid(handle)) [[unlikely]] return false;
+        ++generations_[handle.Index()];
+        free_indices_.push_back(handle.Index());
+        return true;
     }
 
-    void release(T* ptr) {
-        size_t index = ptr - &pool_[0];
-        if (index >= pool_.size()) throw std::logic_error("Pointer not from this pool");
-        free_indices_.push_back(index);
+    bool valid(PoolHandle handle) const {
+        return handle.Index() < capacity_ && generations_[handle.Index()] == handle.Generation();
     }
-};
\ No newline at end of file
+
+    // Checked lookup: nullptr for a stale handle.
+    T* get(PoolHandle handle) { return valid(handle) ? &slot(handle.Index()) : nullptr; }
+    const T* get(PoolHandle handle) const { return valid(handle) ? &slot(handle.Index()) : nullptr; }
+
+    size_t capacity() const { return capacity_; }
+    size_t max_size() const { return max_size_; }
+    size_t available() const { return free_indices_.size() + (max_size_ - capacity_); }
+
+    size_t memory_usage() const {
+        return pool_.capacity() * sizeof(T)
+            + generations_.capacity() * sizeof(std::uint8_t)
+            + free_indices_.capacity() * sizeof(std::uint32_t);
+    }
+
+    // Unchecked lookup for handles the caller knows are live.
+    T& operator[](PoolHandle handle) { return slot(handle.Index()); }
+    const T& operator[](PoolHandle handle) const { return slot(handle.Index()); }
+};
@@ -1,6 +1,9 @@
 #pragma once
-#include <stdexcept>
 #include "Types.h"
+#include "ObjectPool.h"
+
+using OrderHandle = PoolHandle;
+using LevelChunkHandle = PoolHandle;
 
 class Order
 {
@@ -8,12 +11,12 @@ public:
     Order() = default; 
 
     Order(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
-        : orderType_{ orderType }
-        , orderId_{ orderId }
-        , side_{ side }
+        : orderId_{ orderId }
         , price_{ price }
         , initialQuantity_{ quantity }
         , remainingQuantity_{ quantity }
+        , orderType_{ orderType }
+        , side_{ side }
     {}
 
     OrderId GetOrderId() const { return orderId_; }
@@ -25,23 +28,43 @@ public:
     Quantity GetFilledQuantity() const { return GetInitialQuantity() - GetRemainingQuantity(); }
     bool IsFilled() const { return GetRemainingQuantity() == 0; }
     
-    void Fill(Quantity quantity)
+    // Refuses, leaving the order unchanged, to fill more than remains.
+    bool Fill(Quantity quantity)
     {
-        if (quantity > GetRemainingQuantity())
-        {
-            throw std::logic_error("Order cannot be filled for more than its remaining quantity.");
-        }
+        if (quantity > GetRemainingQuantity()) [[unlikely]] return false;
         remainingQuantity_ -= quantity;
+        return true;
+    }
+
+    // Makes the order a fresh one at a new side, price and quantity, as when
+    // an amend re-enters it into the book.
+    void Amend(Side side, Price price, Quantity quantity)
+    {
+        side_ = side;
+        price_ = price;
+        initialQuantity_ = quantity;
+        remainingQuantity_ = quantity;
+    }
+
+    // Gives the order the new id of a cancel-replace.
+    void Rename(OrderId orderId) { orderId_ = orderId; }
+
+    // Sets the open quantity, keeping what has already filled.
+    void Requote(Quantity quantity)
+    {
+        initialQuantity_ = GetFilledQuantity() + quantity;
+        remainingQuantity_ = quantity;
     }
 
-    Order* next_ = nullptr;
-    Order* prev_ = nullptr;
+    // Where the order sits in its level's queue, for O(1) removal.
+    LevelChunkHandle chunk_;
+    std::uint8_t slot_ = 0;
 
 private:
-    OrderType orderType_ = OrderType::GoodTillCancel;
     OrderId orderId_ = 0;
-    Side side_ = Side::Buy;
     Price price_ = 0;
     Quantity initialQuantity_ = 0;
     Quantity remainingQuantity_ = 0;
+    OrderType orderType_ = OrderType::GoodTillCancel;
+    Side side_ = Side::Buy;
 };
\ No newline at end of file
@@ -1,15 +1,18 @@
 #pragma once
-#include <map>
 #include <unordered_map>
+#include <span>
 #include <vector>
 #include <numeric>
 #include <algorithm>
-#include <iostream>
 
 #include "Types.h"
 #include "Order.h"
 #include "OrderList.h"
 #include "ObjectPool.h"
+#include "HalfBook.h"
+#include "ExecutionReport.h"
+#include "ReferenceData.h"
+#include "SlidingIdSet.h"
 
 // --- Helper Structs ---
 struct LevelInfo {
@@ -19,6 +22,63 @@ struct LevelInfo {
 
 using LevelInfos = std::vector<LevelInfo>;
 
+// Best bid and ask with their aggregate quantities. An empty side reports
+// quantity 0 and a price no order can cross.
+struct TopOfBook {
+    Price bidPrice_;
+    Quantity bidQuantity_;
+    Price askPrice_;
+    Quantity askQuantity_;
+};
+
+// Per-book sizing. Everything starts small and grows geometrically on demand;
+// maxOrders_ caps the pool and the initial capacities pre-size structures for
+// a book whose load is known up front (see also OrderBook::Preheat).
+struct OrderBookConfig {
+    std::size_t maxOrders_ = 1000000;
+    std::size_t initialOrders_ = 0;
+    std::size_t indexCapacity_ = 0;
+    std::size_t tradeCapacity_ = 0;
+    std::size_t ladderTicks_ = HalfBook<Side::Buy>::DefaultWindowTicks;
+    std::size_t restingIdWindow_ = SlidingIdSet::DefaultIds;
+    std::size_t sessionIdWindow_ = SlidingIdSet::DefaultIds;
+};
+
+// Bytes a book holds, by structure. Node-based containers are estimated from
+// their element counts.
+struct BookMemoryUsage {
+    std::size_t pool_ = 0;
+    std::size_t index_ = 0;
+    std::size_t levels_ = 0;
+    std::size_t trades_ = 0;
+
+    std::size_t Total() const { return pool_ + index_ + levels_ + trades_; }
+};
+
+// Cancels checked against the window of recently rested ids. filtered_ were
+// rejected without probing the id index; probeMisses_ were older than the
+// window and missed in the index.
+struct CancelFilterStats {
+    std::uint64_t lookups_ = 0;
+    std::uint64_t filtered_ = 0;
+    std::uint64_t probeMisses_ = 0;
+
+    // Share of cancels for unknown ids that the filter answered alone.
+    double HitRate() const
+    {
+        const std::uint64_t unknown = filtered_ + probeMisses_;
+        return unknown ? static_cast<double>(filtered_) / static_cast<double>(unknown) : 0.0;
+    }
+};
+
+// One level of a market maker's quote; see OrderBook::MassQuote.
+struct QuoteEntry {
+    OrderId orderId_;
+    Side side_;
+    Price price_;
+    Quantity quantity_;
+};
+
 class OrderBookLevelInfos {
 public:
     OrderBookLevelInfos(const LevelInfos& bids, const LevelInfos& asks)
@@ -63,7 +123,6 @@ private:
 };
 
 using Trades = std::vector<Trade>;
-using OrderPointer = Order*;
 using OrderPointers = OrderList;
 
 // --- Main Class ---
@@ -72,161 +131,504 @@ class OrderBook
 private:
     struct OrderEntry
     {
-        OrderPointer order_{ nullptr };
+        OrderHandle handle_;
     };
 
-    std::map<Price, OrderPointers, std::greater<Price>> bids_;
-    std::map<Price, OrderPointers, std::less<Price>> asks_;
+    ObjectPool<Order> orderPool_;
+    ObjectPool<LevelChunk> chunkPool_;
+
+    HalfBook<Side::Buy> bids_;
+    HalfBook<Side::Sell> asks_;
     std::unordered_map<OrderId, OrderEntry> orders_;
+    SlidingIdSet restingIds_;
+    SlidingIdSet sessionIds_;
+    CancelFilterStats cancelFilterStats_;
+    std::vector<OrderHandle> cancelBatch_;
+
+    // What the second pass of MassQuote still has to do for each entry, and
+    // the order a Move re-enters.
+    enum class QuoteAction : std::uint8_t { Done, Move, Add };
+    struct PendingQuote
+    {
+        QuoteAction action_ = QuoteAction::Done;
+        OrderHandle handle_;
+    };
+    std::vector<PendingQuote> pendingQuotes_;
     Trades trades_;
-    
-    ObjectPool<Order> orderPool_{ 1000000 };
-
-    bool CanMatch(Side side, Price price) const
-    {
-        if (side == Side::Buy) {
-            if (asks_.empty()) return false;
-            const auto& [bestAsk, _] = *asks_.begin();
-            return price >= bestAsk;
-        } else {
-            if (bids_.empty()) return false;
-            const auto& [bestBid, _] = *bids_.begin();
-            return price <= bestBid;
-        }
+
+    const ReferenceDataReader* referenceData_ = nullptr;
+    InstrumentId instrument_ = 0;
+
+    template<Side S>
+    HalfBook<S>& Half()
+    {
+        if constexpr (S == Side::Buy) return bids_;
+        else return asks_;
     }
 
-    const Trades MatchOrders()
+    // An incoming order is matched against the opposite side before anything
+    // is rested, so an order that fills or is killed never touches its own
+    // side's levels or the id index. The book is uncrossed between
+    // operations, so only the incoming order can trade and a FillAndKill
+    // never rests.
+    template<Side S>
+    ExecutionReport AddOrder(OrderType orderType, OrderId orderId, Price price, Quantity quantity)
     {
-        trades_.clear();
+        const bool crosses = Half<SideTraits<S>::Opposite>().IsCrossedBy(price);
+        if (orderType == OrderType::FillAndKill && !crosses) [[unlikely]]
+            return ExecutionReport{ 0, quantity, OrderStatus::Killed, ErrorCode::None, false };
+
+        // Refuse before trading if the remainder could not be rested.
+        if (orderType != OrderType::FillAndKill && !orderPool_.available()) [[unlikely]]
+            return ExecutionReport::Rejected(ErrorCode::PoolExhausted);
+
+        Quantity remaining = quantity;
+        if (crosses) [[unlikely]] {
+            remaining = MatchIncoming<S>(orderId, price, quantity);
+            const Quantity filled = quantity - remaining;
+            if (remaining == 0) return ExecutionReport{ filled, 0, OrderStatus::Filled, ErrorCode::None, false };
+            if (orderType == OrderType::FillAndKill)
+                return ExecutionReport{ filled, remaining, OrderStatus::Killed, ErrorCode::None, false };
+        }
 
-        while (true)
-        {
-            if (bids_.empty() || asks_.empty()) break;
+        const OrderHandle handle = orderPool_.acquire(orderType, orderId, S, price, quantity);
+        if (!handle) [[unlikely]] return ExecutionReport::Rejected(ErrorCode::PoolExhausted);
+        if (remaining != quantity) orderPool_[handle].Fill(quantity - remaining);
+        Half<S>().Add(handle);
+        orders_.insert({ orderId, OrderEntry{ handle } });
+        restingIds_.Insert(orderId);
 
-            auto& [bidPrice, bids] = *bids_.begin();
-            auto& [askPrice, asks] = *asks_.begin();
+        if (remaining == quantity) [[likely]]
+            return ExecutionReport{ 0, quantity, OrderStatus::New, ErrorCode::None, true };
+        return ExecutionReport{ quantity - remaining, remaining, OrderStatus::PartiallyFilled, ErrorCode::None, true };
+    }
 
-            if (bidPrice < askPrice) break;
+    // Puts an order that has been taken off its level back into the book at
+    // a new side, price and quantity. Its pool slot and index entry are kept,
+    // and it trades first only if the new price crosses.
+    template<Side S>
+    ExecutionReport Reenter(OrderHandle handle, Price price, Quantity quantity)
+    {
+        Order& order = orderPool_[handle];
+        const OrderId orderId = order.GetOrderId();
+        order.Amend(S, price, quantity);
+
+        if (Half<SideTraits<S>::Opposite>().IsCrossedBy(price)) [[unlikely]] {
+            const Quantity remaining = MatchIncoming<S>(orderId, price, quantity);
+            if (remaining == 0) {
+                orders_.erase(orderId);
+                restingIds_.Erase(orderId);
+                orderPool_.release(handle);
+                return ExecutionReport{ quantity, 0, OrderStatus::Filled, ErrorCode::None, false };
+            }
+            if (remaining != quantity) {
+                order.Fill(quantity - remaining);
+                Half<S>().Add(handle);
+                return ExecutionReport{ quantity - remaining, remaining, OrderStatus::PartiallyFilled, ErrorCode::None, true };
+            }
+        }
 
-            while (bids.size() && asks.size())
-            {
-                auto bid = bids.front();
-                auto ask = asks.front();
+        Half<S>().Add(handle);
+        return ExecutionReport{ 0, quantity, OrderStatus::New, ErrorCode::None, true };
+    }
 
-                Quantity quantity = std::min(bid->GetRemainingQuantity(), ask->GetRemainingQuantity());
+    ExecutionReport Reenter(OrderHandle handle, Side side, Price price, Quantity quantity)
+    {
+        return side == Side::Buy
+            ? Reenter<Side::Buy>(handle, price, quantity)
+            : Reenter<Side::Sell>(handle, price, quantity);
+    }
 
-                bid->Fill(quantity);
-                ask->Fill(quantity);
+    // Trades an incoming order against the opposite side, best level first
+    // and FIFO within a level, and returns what is left of it.
+    template<Side S>
+    Quantity MatchIncoming(OrderId orderId, Price price, Quantity quantity)
+    {
+        constexpr Side Opposite = SideTraits<S>::Opposite;
+        HalfBook<Opposite>& opposite = Half<Opposite>();
 
-                if (bid->IsFilled()) {
-                    bids.pop_front();
-                    orders_.erase(bid->GetOrderId());
-                    orderPool_.release(bid);
+        while (quantity && opposite.IsCrossedBy(price))
+        {
+            OrderList& level = opposite.BestLevel();
+            while (quantity && !level.empty())
+            {
+                const OrderHandle handle = level.front(chunkPool_);
+                const Order& resting = orderPool_[handle];
+                const Quantity fill = std::min(quantity, resting.GetRemainingQuantity());
+
+                level.fill(orderPool_, handle, fill);
+                quantity -= fill;
+
+                const TradeInfo incoming{ orderId, price, fill };
+                const TradeInfo contra{ resting.GetOrderId(), resting.GetPrice(), fill };
+                if constexpr (S == Side::Buy) trades_.push_back(Trade{ incoming, contra });
+                else trades_.push_back(Trade{ contra, incoming });
+
+                if (resting.IsFilled()) {
+                    level.pop_front(orderPool_, chunkPool_);
+                    orders_.erase(resting.GetOrderId());
+                    restingIds_.Erase(resting.GetOrderId());
+                    orderPool_.release(handle);
                 }
+            }
+            if (level.empty()) opposite.PopBestLevel();
+        }
+        return quantity;
+    }
 
-                if (ask->IsFilled()) {
-                    asks.pop_front();
-                    orders_.erase(ask->GetOrderId());
-                    orderPool_.release(ask);
-                }
+    ErrorCode Validate(Price price, Quantity quantity) const
+    {
+        if (!referenceData_) return ErrorCode::None;
+        const InstrumentInfo* info = referenceData_->Find(instrument_);
+        return info ? info->Validate(price, quantity) : ErrorCode::UnknownInstrument;
+    }
 
-                trades_.push_back(Trade{
-                    TradeInfo{ bid->GetOrderId(), bid->GetPrice(), quantity },
-                    TradeInfo{ ask->GetOrderId(), ask->GetPrice(), quantity }
-                });
-                
-                bool bidsEmpty = bids.empty();
-                bool asksEmpty = asks.empty();
+    // Every id accepted this session is remembered within the window, so a
+    // reused id is rejected even after its order filled. Ids older than the
+    // window, such as those of a client numbering far below another's, fall
+    // back to catching only orders still resting.
+    bool IsDuplicate(OrderId orderId) const
+    {
+        if (sessionIds_.Below(orderId)) [[unlikely]] return orders_.contains(orderId);
+        return sessionIds_.Contains(orderId);
+    }
 
-                if (bidsEmpty) bids_.erase(bidPrice);
-                if (asksEmpty) asks_.erase(askPrice);
+    // Entry for an order under a new id: checks it and records the id once
+    // the book has accepted it, so an add refused for a full pool can be
+    // retried under the same id. Trades are appended to trades_, which the
+    // public operation clears.
+    ExecutionReport Admit(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
+    {
+        if (IsDuplicate(orderId)) [[unlikely]] return ExecutionReport::Rejected(ErrorCode::DuplicateOrderId);
+        if (const ErrorCode error = Validate(price, quantity); error != ErrorCode::None) [[unlikely]]
+            return ExecutionReport::Rejected(error);
+
+        const ExecutionReport report = side == Side::Buy
+            ? AddOrder<Side::Buy>(orderType, orderId, price, quantity)
+            : AddOrder<Side::Sell>(orderType, orderId, price, quantity);
+        if (!report.IsRejected()) [[likely]] sessionIds_.Insert(orderId);
+        return report;
+    }
 
-                if (bidsEmpty || asksEmpty) break;
-            }
-        }
+    // False only for ids the filter knows are not resting.
+    bool MayRest(OrderId orderId) const
+    {
+        return restingIds_.Below(orderId) || restingIds_.Contains(orderId);
+    }
 
-        if (!bids_.empty()) {
-            auto& [_, bids] = *bids_.begin();
-            if(!bids.empty()){
-                auto order = bids.front();
-                if (order->GetOrderType() == OrderType::FillAndKill) CancelOrder(order->GetOrderId());
-            }
+    // Finds a resting order for cancellation and drops it from the id index
+    // and filter; the order itself stays in its level and pool slot. Most
+    // cancels for gone orders name a recent id, which the filter answers
+    // exactly; only older ids need the index.
+    OrderHandle Unindex(OrderId orderId)
+    {
+        ++cancelFilterStats_.lookups_;
+        if (!MayRest(orderId)) {
+            ++cancelFilterStats_.filtered_;
+            return OrderHandle{};
         }
-        if (!asks_.empty()) {
-            auto& [_, asks] = *asks_.begin();
-            if(!asks.empty()){
-                auto order = asks.front();
-                if (order->GetOrderType() == OrderType::FillAndKill) CancelOrder(order->GetOrderId());
-            }
+
+        auto it = orders_.find(orderId);
+        if (it == orders_.end()) {
+            ++cancelFilterStats_.probeMisses_;
+            return OrderHandle{};
         }
 
-        return trades_;
+        const OrderHandle handle = it->second.handle_;
+        orders_.erase(it);
+        restingIds_.Erase(orderId);
+        return handle;
+    }
+
+    static ExecutionReport CancelledReport(const Order& order)
+    {
+        return ExecutionReport{ order.GetFilledQuantity(), order.GetRemainingQuantity(), OrderStatus::Cancelled, ErrorCode::None, false,
+            order.GetSide(), order.GetPrice() };
+    }
+
+    // Takes an order off its level, leaving its pool slot and index entry.
+    void Unlink(OrderHandle handle)
+    {
+        if (orderPool_[handle].GetSide() == Side::Buy) bids_.Remove(handle);
+        else asks_.Remove(handle);
+    }
+
+    void RemoveOrder(OrderHandle handle)
+    {
+        Unlink(handle);
+        orderPool_.release(handle);
     }
 
 public:
-    OrderBook() {
-        trades_.reserve(10000); 
-        orders_.reserve(1200000);
+    explicit OrderBook(const OrderBookConfig& config = {})
+        : orderPool_{ config.maxOrders_ }
+        , chunkPool_{ config.maxOrders_ }
+        , bids_{ orderPool_, chunkPool_, config.ladderTicks_ }
+        , asks_{ orderPool_, chunkPool_, config.ladderTicks_ }
+        , restingIds_{ config.restingIdWindow_ }
+        , sessionIds_{ config.sessionIdWindow_ }
+    {
+        orderPool_.reserve(config.initialOrders_);
+        chunkPool_.reserve(config.initialOrders_ / LevelChunk::Capacity);
+        trades_.reserve(config.tradeCapacity_);
         orders_.max_load_factor(0.7f);
+        if (config.indexCapacity_) orders_.reserve(config.indexCapacity_);
+    }
+
+    // Sizes the pool, index and trade buffer for a known-hot book so that the
+    // first orders do not pay for growth.
+    void Preheat(std::size_t orders)
+    {
+        orderPool_.reserve(orders);
+        chunkPool_.reserve(orders / LevelChunk::Capacity);
+        orders_.reserve(orders + orders / 5);
+        trades_.reserve(std::min<std::size_t>(orders, 10000));
     }
 
 
-    const Trades& AddOrder(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
+    // Every operation returns an ExecutionReport for the order it addressed;
+    // the trades an AddOrder or MatchOrder produced are available from
+    // GetTrades() until the next operation.
+    ExecutionReport AddOrder(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
+    {
+        trades_.clear();
+        return Admit(orderType, orderId, side, price, quantity);
+    }
+
+    ExecutionReport CancelOrder(OrderId orderId)
     {
-        if (orders_.contains(orderId)) {
-            trades_.clear();
-            return trades_;
+        trades_.clear();
+
+        const OrderHandle handle = Unindex(orderId);
+        if (!handle) return ExecutionReport::Rejected(ErrorCode::UnknownOrderId);
+
+        const ExecutionReport report = CancelledReport(orderPool_[handle]);
+        RemoveOrder(handle);
+        return report;
+    }
+
+    // Cancels a batch in two passes. The first takes every id out of the
+    // filter and index, one lookup at a time as CancelOrder does; the second
+    // unlinks the orders from their levels, and levels the batch emptied are
+    // dropped once at the end rather than per order. reports, if not empty,
+    // receives one report per id in order. Returns the number of orders
+    // cancelled.
+    std::size_t CancelOrders(std::span<const OrderId> orderIds, std::span<ExecutionReport> reports = {})
+    {
+        trades_.clear();
+
+        cancelBatch_.clear();
+        for (const OrderId orderId : orderIds) {
+            cancelBatch_.push_back(Unindex(orderId));
         }
-        
-        if (orderType == OrderType::FillAndKill && !CanMatch(side, price)) return {};
 
-        Order* order = orderPool_.acquire(orderType, orderId, side, price, quantity);
+        std::size_t cancelled = 0;
+        for (std::size_t i = 0; i < cancelBatch_.size(); ++i) {
+            const OrderHandle handle = cancelBatch_[i];
+            if (!handle) {
+                if (!reports.empty()) reports[i] = ExecutionReport::Rejected(ErrorCode::UnknownOrderId);
+                continue;
+            }
 
-        if (order->GetSide() == Side::Buy) {
-            auto& orders = bids_[order->GetPrice()];
-            orders.push_back(order);
-        } else {
-            auto& orders = asks_[order->GetPrice()];
-            orders.push_back(order);
+            const Order& order = orderPool_[handle];
+            if (!reports.empty()) reports[i] = CancelledReport(order);
+            if (order.GetSide() == Side::Buy) bids_.RemoveDeferred(handle);
+            else asks_.RemoveDeferred(handle);
+            orderPool_.release(handle);
+            ++cancelled;
         }
 
-        orders_.insert({ order->GetOrderId(), OrderEntry{ order } });
-        return MatchOrders();
+        bids_.SweepEmptyLevels();
+        asks_.SweepEmptyLevels();
+        return cancelled;
     }
 
-    void CancelOrder(OrderId orderId)
+    // Amends a resting order in place: it leaves its level and re-enters at
+    // the new side, price and quantity, behind orders already there, without
+    // giving up its pool slot or index entry.
+    ExecutionReport MatchOrder(OrderModify order)
     {
-        if (!orders_.contains(orderId)) return;
+        trades_.clear();
 
-        const auto [order] = orders_.at(orderId);
-        orders_.erase(orderId);
+        auto it = orders_.find(order.GetOrderId());
+        if (it == orders_.end()) return ExecutionReport::Rejected(ErrorCode::UnknownOrderId);
+        if (const ErrorCode error = Validate(order.GetPrice(), order.GetQuantity()); error != ErrorCode::None)
+            return ExecutionReport::Rejected(error);
+
+        const OrderHandle handle = it->second.handle_;
+        const Order& resting = orderPool_[handle];
+        const Side fromSide = resting.GetSide();
+        const Price fromPrice = resting.GetPrice();
+        Unlink(handle);
+        ExecutionReport report = Reenter(handle, order.GetSide(), order.GetPrice(), order.GetQuantity());
+        report.fromSide_ = fromSide;
+        report.fromPrice_ = fromPrice;
+        return report;
+    }
 
-        if (order->GetSide() == Side::Sell) {
-            auto price = order->GetPrice();
-            auto& orders = asks_.at(price);
-            orders.remove(order);
-            if (orders.empty()) asks_.erase(price);
-        } else {
-            auto price = order->GetPrice();
-            auto& orders = bids_.at(price);
-            orders.remove(order);
-            if (orders.empty()) bids_.erase(price);
+    // Cancel-replace under a fresh id: the order keeps its side, pool slot
+    // and index node, which is re-keyed from oldId to newId, and re-enters
+    // at the new price and quantity as MatchOrder does. newId goes through
+    // the same duplicate check as an AddOrder. The report is for newId.
+    ExecutionReport Replace(OrderId oldId, OrderId newId, Price price, Quantity quantity)
+    {
+        trades_.clear();
+
+        if (IsDuplicate(newId)) [[unlikely]] return ExecutionReport::Rejected(ErrorCode::DuplicateOrderId);
+        if (const ErrorCode error = Validate(price, quantity); error != ErrorCode::None) [[unlikely]]
+            return ExecutionReport::Rejected(error);
+
+        auto node = orders_.extract(oldId);
+        if (node.empty()) return ExecutionReport::Rejected(ErrorCode::UnknownOrderId);
+
+        const OrderHandle handle = node.mapped().handle_;
+        node.key() = newId;
+        orders_.insert(std::move(node));
+        restingIds_.Erase(oldId);
+        restingIds_.Insert(newId);
+        sessionIds_.Insert(newId);
+
+        Unlink(handle);
+        Order& order = orderPool_[handle];
+        const Price fromPrice = order.GetPrice();
+        order.Rename(newId);
+        ExecutionReport report = Reenter(handle, order.GetSide(), price, quantity);
+        report.fromSide_ = order.GetSide();
+        report.fromPrice_ = fromPrice;
+        return report;
+    }
+
+    // Replaces a market maker's quotes at many levels in one call. Each entry
+    // names the resting quote order it replaces:
+    //  - quantity 0 cancels it;
+    //  - at the same side and price it is requoted in place, keeping its pool
+    //    slot and index entry, and its queue position unless it grows;
+    //  - at a new price it is taken off its level and re-entered there, as
+    //    MatchOrder does;
+    //  - an id that is not resting enters as a new GoodTillCancel order.
+    // All pulls and in-place changes happen before anything is entered, so a
+    // quote never trades against the stale side of the same mass quote.
+    // reports, if not empty, receives one report per entry in order; trades
+    // from every entry are available from GetTrades(). Returns the number of
+    // entries applied.
+    std::size_t MassQuote(std::span<const QuoteEntry> quotes, std::span<ExecutionReport> reports = {})
+    {
+        trades_.clear();
+
+        pendingQuotes_.assign(quotes.size(), PendingQuote{});
+        std::size_t applied = 0;
+        auto Report = [&](std::size_t i, const ExecutionReport& report) {
+            if (!reports.empty()) reports[i] = report;
+            if (!report.IsRejected()) ++applied;
+        };
+
+        for (std::size_t i = 0; i < quotes.size(); ++i) {
+            const QuoteEntry& quote = quotes[i];
+            if (quote.quantity_ != 0) {
+                if (const ErrorCode error = Validate(quote.price_, quote.quantity_); error != ErrorCode::None) {
+                    Report(i, ExecutionReport::Rejected(error));
+                    continue;
+                }
+            }
+
+            auto it = orders_.find(quote.orderId_);
+            if (it == orders_.end()) {
+                if (quote.quantity_ == 0) Report(i, ExecutionReport::Rejected(ErrorCode::UnknownOrderId));
+                else pendingQuotes_[i].action_ = QuoteAction::Add;
+                continue;
+            }
+
+            const OrderHandle handle = it->second.handle_;
+            const Order& order = orderPool_[handle];
+            if (!order.chunk_) {
+                // Already taken off its level by an earlier entry to move.
+                Report(i, ExecutionReport::Rejected(ErrorCode::DuplicateOrderId));
+                continue;
+            }
+            if (quote.quantity_ != 0 && order.GetSide() == quote.side_ && order.GetPrice() == quote.price_) {
+                if (quote.side_ == Side::Buy) bids_.Requote(handle, quote.quantity_);
+                else asks_.Requote(handle, quote.quantity_);
+                Report(i, ExecutionReport{ order.GetFilledQuantity(), order.GetRemainingQuantity(), OrderStatus::New, ErrorCode::None, true });
+                continue;
+            }
+
+            if (quote.quantity_ != 0) {
+                pendingQuotes_[i] = PendingQuote{ QuoteAction::Move, handle };
+                Unlink(handle);
+                continue;
+            }
+
+            Report(i, CancelledReport(order));
+            orders_.erase(it);
+            restingIds_.Erase(quote.orderId_);
+            RemoveOrder(handle);
         }
 
-        orderPool_.release(order); 
+        for (std::size_t i = 0; i < quotes.size(); ++i) {
+            const QuoteEntry& quote = quotes[i];
+            if (pendingQuotes_[i].action_ == QuoteAction::Move)
+                Report(i, Reenter(pendingQuotes_[i].handle_, quote.side_, quote.price_, quote.quantity_));
+            else if (pendingQuotes_[i].action_ == QuoteAction::Add)
+                Report(i, Admit(OrderType::GoodTillCancel, quote.orderId_, quote.side_, quote.price_, quote.quantity_));
+        }
+        return applied;
     }
 
-    Trades MatchOrder(OrderModify order)
+    const Trades& GetTrades() const { return trades_; }
+
+    // Orders are validated against this instrument's entry in the reader's
+    // table. The reader belongs to the thread that drives this book.
+    void AttachReferenceData(const ReferenceDataReader& reader, InstrumentId instrument)
     {
-        if (!orders_.contains(order.GetOrderId())) return {};
-        const auto& [existingOrder] = orders_.at(order.GetOrderId());
-        OrderType type = existingOrder->GetOrderType(); 
-        CancelOrder(order.GetOrderId());
-        return AddOrder(type, order.GetOrderId(), order.GetSide(), order.GetPrice(), order.GetQuantity());
+        referenceData_ = &reader;
+        instrument_ = instrument;
     }
 
     std::size_t Size() const { return orders_.size(); }
 
+    // Whether an order under orderId was accepted this session, resting or
+    // not. Ids older than the session window are reported as unknown.
+    bool IsKnownOrderId(OrderId orderId) const { return sessionIds_.Contains(orderId); }
+
+    // Answers from the resting-id filter where it can, so callers that look
+    // an order up before cancelling it do not probe the index for stale ids.
+    const Order* FindOrder(OrderId orderId) const
+    {
+        if (!MayRest(orderId)) return nullptr;
+        auto it = orders_.find(orderId);
+        return it == orders_.end() ? nullptr : orderPool_.get(it->second.handle_);
+    }
+
+    Quantity GetLevelQuantity(Side side, Price price) const
+    {
+        return side == Side::Buy ? bids_.LevelQuantity(price) : asks_.LevelQuantity(price);
+    }
+
+    TopOfBook GetTopOfBook() const
+    {
+        return TopOfBook{ bids_.BestPrice(), bids_.BestQuantity(), asks_.BestPrice(), asks_.BestQuantity() };
+    }
+
+    // Level-store operations that left the dense window, and levels moved
+    // between the window and the sparse store, over both sides.
+    std::uint64_t SparseLevelOperations() const { return bids_.SparseOperations() + asks_.SparseOperations(); }
+    std::uint64_t LevelMigrations() const { return bids_.Migrations() + asks_.Migrations(); }
+
+    const CancelFilterStats& GetCancelFilterStats() const { return cancelFilterStats_; }
+
+    BookMemoryUsage GetMemoryUsage() const
+    {
+        using IndexNode = std::pair<std::pair<const OrderId, OrderEntry>, void*>;
+
+        BookMemoryUsage usage;
+        usage.pool_ = orderPool_.memory_usage();
+        usage.index_ = orders_.bucket_count() * sizeof(void*) + orders_.size() * sizeof(IndexNode)
+            + restingIds_.MemoryUsage() + sessionIds_.MemoryUsage();
+        usage.levels_ = bids_.MemoryUsage() + asks_.MemoryUsage() + chunkPool_.memory_usage();
+        usage.trades_ = trades_.capacity() * sizeof(Trade);
+        return usage;
+    }
+
     OrderBookLevelInfos GetOrderInfos() const
     {
         LevelInfos bidInfos, askInfos;
@@ -235,15 +637,11 @@ public:
 
         auto CreateLevelInfos = [](Price price, const OrderPointers& orders)
         {
-            return LevelInfo{ price, std::accumulate(orders.begin(), orders.end(), (Quantity)0,
-                [](Quantity runningSum, const Order* order)
-            { return runningSum + order->GetRemainingQuantity(); }) };
+            return LevelInfo{ price, orders.quantity() };
         };
 
-        for (const auto& [price, orders] : bids_)
-            bidInfos.push_back(CreateLevelInfos(price, orders));
-        for (const auto& [price, orders] : asks_)
-            askInfos.push_back(CreateLevelInfos(price, orders));
+        bids_.ForEachLevel([&](Price price, const OrderPointers& orders) { bidInfos.push_back(CreateLevelInfos(price, orders)); });
+        asks_.ForEachLevel([&](Price price, const OrderPointers& orders) { askInfos.push_back(CreateLevelInfos(price, orders)); });
 
         return OrderBookLevelInfos{ bidInfos, askInfos };
     }
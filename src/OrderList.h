@@ -1,77 +1,148 @@
 #pragma once
+#include <cstdint>
+
 #include "Order.h"
 
+// One cache line of a level's queue: order handles in arrival order, linked
+// to the neighbouring chunks. Slots of removed orders are nulled in place;
+// begin_ is the first live slot and end_ the next free one.
+struct alignas(64) LevelChunk
+{
+    static constexpr std::uint8_t Capacity = 13;
+
+    OrderHandle slots_[Capacity];
+    LevelChunkHandle next_;
+    LevelChunkHandle prev_;
+    std::uint8_t begin_ = 0;
+    std::uint8_t end_ = 0;
+    std::uint8_t live_ = 0;
+};
+
+static_assert(sizeof(LevelChunk) == 64);
+
+// FIFO of resting orders at one price, stored as an unrolled list of
+// LevelChunks so walking a deep level reads handles sequentially. Each order
+// records its chunk and slot, so removal from the middle stays O(1); a chunk
+// is returned to the pool as soon as its last live order leaves. A level
+// holds only its ends and totals: the book-wide order and chunk pools are
+// passed to every operation that resolves a handle, so a dense window of
+// levels stays compact.
 class OrderList
 {
 public:
-    OrderList() = default;
+    using Pool = ObjectPool<Order>;
+    using ChunkPool = ObjectPool<LevelChunk>;
 
-    void push_back(Order* order)
+    // The chunk pool holds one chunk per order, so a push cannot fail for
+    // lack of one.
+    void push_back(Pool& pool, ChunkPool& chunks, OrderHandle handle)
     {
-        if (!head_)
+        if (!tail_ || chunks[tail_].end_ == LevelChunk::Capacity)
         {
-            head_ = order;
-            tail_ = order;
-            order->prev_ = nullptr;
-            order->next_ = nullptr;
+            const LevelChunkHandle chunk = chunks.acquire();
+            chunks[chunk].prev_ = tail_;
+            if (tail_) chunks[tail_].next_ = chunk;
+            else head_ = chunk;
+            tail_ = chunk;
         }
-        else
-        {
-            tail_->next_ = order;
-            order->prev_ = tail_;
-            order->next_ = nullptr;
-            tail_ = order;
+
+        LevelChunk& chunk = chunks[tail_];
+        Order& order = pool[handle];
+        order.chunk_ = tail_;
+        order.slot_ = chunk.end_;
+        chunk.slots_[chunk.end_++] = handle;
+        chunk.live_++;
+        size_++;
+        quantity_ += order.GetRemainingQuantity();
+    }
+
+    void remove(Pool& pool, ChunkPool& chunks, OrderHandle handle)
+    {
+        Order& order = pool[handle];
+        const LevelChunkHandle chunkHandle = order.chunk_;
+        LevelChunk& chunk = chunks[chunkHandle];
+
+        chunk.slots_[order.slot_] = OrderHandle{};
+        order.chunk_ = LevelChunkHandle{};
+        size_--;
+        quantity_ -= order.GetRemainingQuantity();
+
+        if (--chunk.live_ == 0) unlink(chunks, chunkHandle, chunk);
+        else if (order.slot_ == chunk.begin_) skip_removed(chunk);
+    }
+
+    bool fill(Pool& pool, OrderHandle handle, Quantity quantity)
+    {
+        if (!pool[handle].Fill(quantity)) return false;
+        quantity_ -= quantity;
+        return true;
+    }
+
+    // Sets a queued order's open quantity. A reduction keeps its place; an
+    // increase forfeits time priority and sends it to the back.
+    void requote(Pool& pool, ChunkPool& chunks, OrderHandle handle, Quantity quantity)
+    {
+        Order& order = pool[handle];
+        if (quantity > order.GetRemainingQuantity()) {
+            remove(pool, chunks, handle);
+            order.Requote(quantity);
+            push_back(pool, chunks, handle);
+        } else {
+            quantity_ -= order.GetRemainingQuantity() - quantity;
+            order.Requote(quantity);
         }
-        size_++; 
     }
 
-    void remove(Order* order)
+    OrderHandle front(const ChunkPool& chunks) const
     {
-        if (order->prev_) order->prev_->next_ = order->next_;
-        else head_ = order->next_;
+        if (!head_) return OrderHandle{};
+        const LevelChunk& chunk = chunks[head_];
+        return chunk.slots_[chunk.begin_];
+    }
 
-        if (order->next_) order->next_->prev_ = order->prev_;
-        else tail_ = order->prev_;
+    // Matching pops the front repeatedly, so this works from the head chunk
+    // rather than going through the order's back-reference.
+    void pop_front(Pool& pool, ChunkPool& chunks)
+    {
+        if (!head_) return;
+        const LevelChunkHandle chunkHandle = head_;
+        LevelChunk& chunk = chunks[chunkHandle];
+        Order& order = pool[chunk.slots_[chunk.begin_]];
 
-        order->prev_ = nullptr;
-        order->next_ = nullptr;
+        chunk.slots_[chunk.begin_] = OrderHandle{};
+        order.chunk_ = LevelChunkHandle{};
         size_--;
+        quantity_ -= order.GetRemainingQuantity();
+
+        if (--chunk.live_ == 0) unlink(chunks, chunkHandle, chunk);
+        else skip_removed(chunk);
     }
 
-    Order* front() const { return head_; }
-    void pop_front() { if (head_) remove(head_); }
-    bool empty() const { return head_ == nullptr; }
+    bool empty() const { return !head_; }
     size_t size() const { return size_; }
-
-    class Iterator {
-    public:
-        Iterator(Order* ptr) : ptr_(ptr) {}
-        Order* operator*() { return ptr_; }
-        Iterator& operator++() { if (ptr_) ptr_ = ptr_->next_; return *this; }
-        bool operator!=(const Iterator& other) const { return ptr_ != other.ptr_; }
-        bool operator==(const Iterator& other) const { return ptr_ == other.ptr_; }
-    private:
-        Order* ptr_;
-    };
-
-    class ConstIterator {
-    public:
-        ConstIterator(const Order* ptr) : ptr_(ptr) {}
-        const Order* operator*() const { return ptr_; }
-        ConstIterator& operator++() { if (ptr_) ptr_ = ptr_->next_; return *this; }
-        bool operator!=(const ConstIterator& other) const { return ptr_ != other.ptr_; }
-        bool operator==(const ConstIterator& other) const { return ptr_ == other.ptr_; }
-    private:
-        const Order* ptr_;
-    };
-
-    Iterator begin() { return Iterator(head_); }
-    Iterator end() { return Iterator(nullptr); }
-    ConstIterator begin() const { return ConstIterator(head_); }
-    ConstIterator end() const { return ConstIterator(nullptr); }
+    Quantity quantity() const { return quantity_; }
 
 private:
-    Order* head_ = nullptr;
-    Order* tail_ = nullptr;
-    size_t size_ = 0;
-};
\ No newline at end of file
+    void unlink(ChunkPool& chunks, LevelChunkHandle handle, const LevelChunk& chunk)
+    {
+        if (chunk.prev_) chunks[chunk.prev_].next_ = chunk.next_;
+        else head_ = chunk.next_;
+
+        if (chunk.next_) chunks[chunk.next_].prev_ = chunk.prev_;
+        else tail_ = chunk.prev_;
+
+        chunks.release(handle);
+    }
+
+    static void skip_removed(LevelChunk& chunk)
+    {
+        while (!chunk.slots_[chunk.begin_]) chunk.begin_++;
+    }
+
+    LevelChunkHandle head_;
+    LevelChunkHandle tail_;
+    std::uint32_t size_ = 0;
+    Quantity quantity_ = 0;
+};
+
+static_assert(sizeof(OrderList) == 16);
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// User-space instruction/cycle/branch-miss counters for the calling thread,
+// via perf_event_open. IsValid() is false where the kernel or sandbox does not
+// allow it, in which case the benchmark simply skips the IPC line.
+class PerfCounters
+{
+public:
+    struct Sample
+    {
+        std::uint64_t instructions_ = 0;
+        std::uint64_t cycles_ = 0;
+        std::uint64_t branchMisses_ = 0;
+
+        double Ipc() const { return cycles_ ? static_cast<double>(instructions_) / static_cast<double>(cycles_) : 0.0; }
+    };
+
+    PerfCounters()
+    {
+#ifdef __linux__
+        instructions_ = Open(PERF_COUNT_HW_INSTRUCTIONS);
+        cycles_ = Open(PERF_COUNT_HW_CPU_CYCLES);
+        branchMisses_ = Open(PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (int fd : { instructions_, cycles_, branchMisses_ })
+            if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool IsValid() const { return instructions_ >= 0 && cycles_ >= 0; }
+
+    void Start()
+    {
+#ifdef __linux__
+        for (int fd : { instructions_, cycles_, branchMisses_ }) {
+            if (fd < 0) continue;
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    Sample Stop()
+    {
+        Sample sample;
+#ifdef __linux__
+        for (int fd : { instructions_, cycles_, branchMisses_ })
+            if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        sample.instructions_ = Read(instructions_);
+        sample.cycles_ = Read(cycles_);
+        sample.branchMisses_ = Read(branchMisses_);
+#endif
+        return sample;
+    }
+
+private:
+#ifdef __linux__
+    static int Open(std::uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static std::uint64_t Read(int fd)
+    {
+        std::uint64_t value = 0;
+        if (fd < 0 || ::read(fd, &value, sizeof(value)) != sizeof(value)) return 0;
+        return value;
+    }
+#endif
+
+    int instructions_ = -1;
+    int cycles_ = -1;
+    int branchMisses_ = -1;
+};
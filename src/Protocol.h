@@ -0,0 +1,203 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "Types.h"
+#include "IngressQueue.h"
+
+// Binary order-entry protocol. Every message starts with a MessageHeader whose
+// length_ covers the whole message; fields are little-endian and packed.
+namespace Protocol
+{
+    enum class MessageType : std::uint8_t
+    {
+        NewOrder = 'N',
+        Cancel = 'C',
+        Modify = 'M',
+        Replace = 'R',
+        ExecutionReport = 'E',
+        Fill = 'F'
+    };
+
+    enum class ExecStatus : std::uint8_t
+    {
+        New,
+        PartiallyFilled,
+        Filled,
+        Cancelled,
+        Rejected,
+        // A FillAndKill whose remainder was not rested. Appended so the
+        // earlier values keep their wire encoding.
+        Killed
+    };
+
+#pragma pack(push, 1)
+    struct MessageHeader
+    {
+        std::uint16_t length_;
+        MessageType type_;
+        std::uint8_t reserved_;
+    };
+
+    struct NewOrderMessage
+    {
+        MessageHeader header_;
+        OrderId orderId_;
+        Price price_;
+        Quantity quantity_;
+        std::uint8_t side_;
+        std::uint8_t orderType_;
+    };
+
+    struct CancelMessage
+    {
+        MessageHeader header_;
+        OrderId orderId_;
+    };
+
+    struct ModifyMessage
+    {
+        MessageHeader header_;
+        OrderId orderId_;
+        Price price_;
+        Quantity quantity_;
+        std::uint8_t side_;
+    };
+
+    // Cancel-replace: the order origOrderId_ continues as orderId_.
+    struct ReplaceMessage
+    {
+        MessageHeader header_;
+        OrderId origOrderId_;
+        OrderId orderId_;
+        Price price_;
+        Quantity quantity_;
+    };
+
+    struct ExecutionReportMessage
+    {
+        MessageHeader header_;
+        OrderId orderId_;
+        Quantity filledQuantity_;
+        ExecStatus status_;
+        ErrorCode reason_;      // why a Rejected was refused, otherwise None
+        std::uint8_t resting_;  // 1 if the order rests on the book afterwards
+    };
+
+    struct FillMessage
+    {
+        MessageHeader header_;
+        OrderId orderId_;
+        OrderId contraOrderId_;
+        Price price_;
+        Quantity quantity_;
+    };
+#pragma pack(pop)
+
+    template<typename Message>
+    constexpr MessageHeader MakeHeader(MessageType type)
+    {
+        return MessageHeader{ static_cast<std::uint16_t>(sizeof(Message)), type, 0 };
+    }
+
+    inline std::size_t ExpectedLength(MessageType type)
+    {
+        switch (type)
+        {
+        case MessageType::NewOrder: return sizeof(NewOrderMessage);
+        case MessageType::Cancel: return sizeof(CancelMessage);
+        case MessageType::Modify: return sizeof(ModifyMessage);
+        case MessageType::Replace: return sizeof(ReplaceMessage);
+        case MessageType::ExecutionReport: return sizeof(ExecutionReportMessage);
+        case MessageType::Fill: return sizeof(FillMessage);
+        }
+        return 0;
+    }
+
+    enum class ParseResult
+    {
+        Complete,
+        NeedMore,
+        Malformed
+    };
+
+    // Inspects the front of a receive buffer. On Complete, header and length
+    // describe the message starting at data; the caller decodes it in place.
+    inline ParseResult PeekMessage(const char* data, std::size_t size, MessageHeader& header)
+    {
+        if (size < sizeof(MessageHeader)) return ParseResult::NeedMore;
+        std::memcpy(&header, data, sizeof(MessageHeader));
+        if (header.length_ != ExpectedLength(header.type_)) return ParseResult::Malformed;
+        if (size < header.length_) return ParseResult::NeedMore;
+        return ParseResult::Complete;
+    }
+
+    template<typename Message>
+    inline Message Decode(const char* data)
+    {
+        Message message;
+        std::memcpy(&message, data, sizeof(Message));
+        return message;
+    }
+
+    // Enum bytes come straight from the client and must name a real value.
+    inline bool IsValidSide(std::uint8_t side) { return side <= static_cast<std::uint8_t>(Side::Sell); }
+    inline bool IsValidOrderType(std::uint8_t orderType) { return orderType <= static_cast<std::uint8_t>(OrderType::FillAndKill); }
+
+    // Decodes an inbound order-entry message into a Command for the ingress
+    // queue. Returns false for message types a client may not send and for
+    // out-of-range side or order type bytes.
+    inline bool ToCommand(const MessageHeader& header, const char* message, std::uint32_t sessionId, Command& command)
+    {
+        command = Command{};
+        command.sessionId_ = sessionId;
+        switch (header.type_)
+        {
+        case MessageType::NewOrder:
+        {
+            const auto order = Decode<NewOrderMessage>(message);
+            if (!IsValidOrderType(order.orderType_) || !IsValidSide(order.side_)) return false;
+            command.type_ = CommandType::Add;
+            command.orderType_ = static_cast<OrderType>(order.orderType_);
+            command.side_ = static_cast<Side>(order.side_);
+            command.orderId_ = order.orderId_;
+            command.price_ = order.price_;
+            command.quantity_ = order.quantity_;
+            return true;
+        }
+        case MessageType::Cancel:
+        {
+            const auto cancel = Decode<CancelMessage>(message);
+            command.type_ = CommandType::Cancel;
+            command.orderId_ = cancel.orderId_;
+            return true;
+        }
+        case MessageType::Modify:
+        {
+            const auto modify = Decode<ModifyMessage>(message);
+            if (!IsValidSide(modify.side_)) return false;
+            command.type_ = CommandType::Modify;
+            command.orderType_ = OrderType::GoodTillCancel;
+            command.side_ = static_cast<Side>(modify.side_);
+            command.orderId_ = modify.orderId_;
+            command.price_ = modify.price_;
+            command.quantity_ = modify.quantity_;
+            return true;
+        }
+        case MessageType::Replace:
+        {
+            const auto replace = Decode<ReplaceMessage>(message);
+            command.type_ = CommandType::Replace;
+            command.orderType_ = OrderType::GoodTillCancel;
+            command.orderId_ = replace.orderId_;
+            command.replacedOrderId_ = replace.origOrderId_;
+            command.price_ = replace.price_;
+            command.quantity_ = replace.quantity_;
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+}
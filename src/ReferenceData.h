@@ -0,0 +1,182 @@
+#pragma once
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Types.h"
+
+// Static trading parameters for one instrument.
+struct InstrumentInfo
+{
+    Price tickSize_ = 1;
+    Price lowBand_ = std::numeric_limits<Price>::min();
+    Price highBand_ = std::numeric_limits<Price>::max();
+    Quantity lotSize_ = 1;
+    Quantity maxQuantity_ = std::numeric_limits<Quantity>::max();
+
+    // Tick and lot sizes divide every incoming price and quantity.
+    bool IsValid() const { return tickSize_ > 0 && lotSize_ > 0; }
+
+    // Requires IsValid(); InstrumentTable only hands out valid entries.
+    ErrorCode Validate(Price price, Quantity quantity) const
+    {
+        if (price % tickSize_ != 0) return ErrorCode::InvalidPrice;
+        if (price < lowBand_ || price > highBand_) return ErrorCode::PriceOutOfBand;
+        if (quantity == 0 || quantity % lotSize_ != 0 || quantity > maxQuantity_) return ErrorCode::InvalidQuantity;
+        return ErrorCode::None;
+    }
+};
+
+// Immutable snapshot of every instrument, indexed by InstrumentId. Never
+// modified once published; intraday changes publish a new table. Entries
+// that fail InstrumentInfo::IsValid are not found, so orders for them are
+// rejected as UnknownInstrument.
+class InstrumentTable
+{
+public:
+    explicit InstrumentTable(std::vector<InstrumentInfo> instruments)
+        : instruments_{ std::move(instruments) }
+        , valid_{ std::all_of(instruments_.begin(), instruments_.end(), [](const InstrumentInfo& info) { return info.IsValid(); }) }
+    {}
+
+    std::size_t size() const { return instruments_.size(); }
+    bool IsValid() const { return valid_; }
+
+    const InstrumentInfo* Find(InstrumentId id) const
+    {
+        if (id >= instruments_.size() || !instruments_[id].IsValid()) return nullptr;
+        return &instruments_[id];
+    }
+
+private:
+    std::vector<InstrumentInfo> instruments_;
+    bool valid_;
+};
+
+class ReferenceDataReader;
+
+// Publishes InstrumentTables RCU-style. The writer swaps the current pointer
+// and retires the old table with the epoch of the swap; a retired table is
+// freed once every registered reader has passed a quiescent point (called
+// Refresh) at or after that epoch. Publish and Reclaim may run on any thread.
+class ReferenceDataStore
+{
+public:
+    explicit ReferenceDataStore(std::unique_ptr<const InstrumentTable> initial)
+        : current_{ initial.release() }
+    {}
+
+    ~ReferenceDataStore()
+    {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    ReferenceDataStore(const ReferenceDataStore&) = delete;
+    ReferenceDataStore& operator=(const ReferenceDataStore&) = delete;
+
+    // Refuses a table with an invalid entry and keeps the current one.
+    bool Publish(std::unique_ptr<const InstrumentTable> table)
+    {
+        if (!table->IsValid()) return false;
+        std::lock_guard lock{ mutex_ };
+        const InstrumentTable* old = current_.exchange(table.release(), std::memory_order_seq_cst);
+        const std::uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        retired_.push_back(Retired{ std::unique_ptr<const InstrumentTable>{ old }, epoch });
+        ReclaimLocked();
+        return true;
+    }
+
+    // Frees retired tables no reader can still hold. Returns how many remain.
+    std::size_t Reclaim()
+    {
+        std::lock_guard lock{ mutex_ };
+        ReclaimLocked();
+        return retired_.size();
+    }
+
+    std::uint64_t Epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+private:
+    friend class ReferenceDataReader;
+
+    struct Retired
+    {
+        std::unique_ptr<const InstrumentTable> table_;
+        std::uint64_t epoch_;
+    };
+
+    void ReclaimLocked();
+    void Register(ReferenceDataReader* reader);
+    void Unregister(ReferenceDataReader* reader);
+
+    std::atomic<const InstrumentTable*> current_;
+    std::atomic<std::uint64_t> epoch_{ 0 };
+    std::mutex mutex_;
+    std::vector<ReferenceDataReader*> readers_;
+    std::vector<Retired> retired_;
+};
+
+// One per matching thread. Between Refresh calls the thread reads a plain
+// pointer to the table it last saw: no atomics, no reference counting. The
+// owning thread calls Refresh at a quiescent point, typically once per poll,
+// and must not hold InstrumentInfo pointers across it.
+class ReferenceDataReader
+{
+public:
+    explicit ReferenceDataReader(ReferenceDataStore& store)
+        : store_{ store }
+    {
+        store_.Register(this);
+    }
+
+    ~ReferenceDataReader() { store_.Unregister(this); }
+
+    ReferenceDataReader(const ReferenceDataReader&) = delete;
+    ReferenceDataReader& operator=(const ReferenceDataReader&) = delete;
+
+    // Reading the epoch before the pointer means the announced epoch never
+    // covers a table this reader could still be looking at.
+    void Refresh()
+    {
+        const std::uint64_t epoch = store_.epoch_.load(std::memory_order_acquire);
+        table_ = store_.current_.load(std::memory_order_acquire);
+        quiescentEpoch_.store(epoch, std::memory_order_release);
+    }
+
+    const InstrumentTable& Table() const { return *table_; }
+    const InstrumentInfo* Find(InstrumentId id) const { return table_->Find(id); }
+
+private:
+    friend class ReferenceDataStore;
+
+    ReferenceDataStore& store_;
+    const InstrumentTable* table_ = nullptr;
+    alignas(64) std::atomic<std::uint64_t> quiescentEpoch_{ 0 };
+};
+
+inline void ReferenceDataStore::ReclaimLocked()
+{
+    std::uint64_t oldest = epoch_.load(std::memory_order_acquire);
+    for (const ReferenceDataReader* reader : readers_)
+        oldest = std::min(oldest, reader->quiescentEpoch_.load(std::memory_order_acquire));
+
+    std::erase_if(retired_, [oldest](const Retired& retired) { return retired.epoch_ <= oldest; });
+}
+
+inline void ReferenceDataStore::Register(ReferenceDataReader* reader)
+{
+    std::lock_guard lock{ mutex_ };
+    reader->Refresh();
+    readers_.push_back(reader);
+}
+
+inline void ReferenceDataStore::Unregister(ReferenceDataReader* reader)
+{
+    std::lock_guard lock{ mutex_ };
+    std::erase(readers_, reader);
+    ReclaimLocked();
+}
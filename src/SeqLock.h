@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "EventLoop.h"
+
+// Single-writer sequence lock for small trivially copyable values. The writer
+// never waits; readers retry while a store is in progress. Used to publish
+// the book's TopOfBook from the matching thread to any number of readers.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+class SeqLock
+{
+public:
+    void Store(const T& value)
+    {
+        const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&value_, &value, sizeof(T));
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Fails if a store overlapped the read.
+    bool TryLoad(T& out) const
+    {
+        const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        std::memcpy(&out, &value_, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) == before;
+    }
+
+    T Load() const
+    {
+        T value;
+        while (!TryLoad(value)) CpuRelax();
+        return value;
+    }
+
+    // Number of completed stores.
+    std::uint64_t Version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> sequence_{ 0 };
+    T value_{};
+};
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <new>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+
+#include <sys/mman.h>
+
+#include "Transport.h"
+
+// Single-producer/single-consumer ring of fixed-size frame slots living in a
+// shared mapping. Frames are read in place: a received burst is only handed
+// back to the producer on the next Receive, so steady-state operation is pure
+// loads and stores with no system calls.
+class FrameRing
+{
+public:
+    struct Slot
+    {
+        std::uint32_t length_;
+        char data_[Transport::MaxFrameSize];
+    };
+
+    static std::size_t BytesFor(std::size_t slots) { return sizeof(FrameRing) + slots * sizeof(Slot); }
+
+    explicit FrameRing(std::size_t slots)
+        : mask_{ slots - 1 }
+    {}
+
+    std::size_t Receive(std::span<Frame> frames)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed) + pending_;
+        head_.store(head, std::memory_order_release);
+        pending_ = 0;
+
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        std::size_t count = 0;
+        for (; count < frames.size() && head + count != tail; ++count) {
+            const Slot& slot = Slots()[(head + count) & mask_];
+            frames[count] = Frame{ slot.data_, slot.length_ };
+        }
+        pending_ = count;
+        return count;
+    }
+
+    std::size_t Send(std::span<const Frame> frames)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        std::size_t count = 0;
+        for (; count < frames.size() && tail + count - head <= mask_; ++count) {
+            const Frame& frame = frames[count];
+            if (frame.length_ > Transport::MaxFrameSize) break;
+            Slot& slot = Slots()[(tail + count) & mask_];
+            slot.length_ = static_cast<std::uint32_t>(frame.length_);
+            std::memcpy(slot.data_, frame.data_, frame.length_);
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    Slot* Slots() { return reinterpret_cast<Slot*>(this + 1); }
+
+    const std::size_t mask_;
+
+    alignas(64) std::atomic<std::size_t> head_{ 0 };
+    std::size_t pending_ = 0;
+
+    alignas(64) std::atomic<std::size_t> tail_{ 0 };
+};
+
+class ShmTransport : public Transport
+{
+public:
+    ShmTransport(FrameRing& rx, FrameRing& tx)
+        : rx_{ rx }, tx_{ tx }
+    {}
+
+    std::size_t Receive(std::span<Frame> frames) override { return rx_.Receive(frames); }
+    std::size_t Send(std::span<const Frame> frames) override { return tx_.Send(frames); }
+
+private:
+    FrameRing& rx_;
+    FrameRing& tx_;
+};
+
+// A connected pair of shared-memory transports: what one side sends, the
+// other receives. The rings live in a MAP_SHARED mapping so the pair also
+// works across fork().
+class ShmLoopback
+{
+public:
+    explicit ShmLoopback(std::size_t slots = 1024)
+    {
+        std::size_t size = 1;
+        while (size < slots) size <<= 1;
+
+        ringBytes_ = (FrameRing::BytesFor(size) + 63) & ~std::size_t{ 63 };
+        mappingBytes_ = 2 * ringBytes_;
+        void* mapping = ::mmap(nullptr, mappingBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) return;
+
+        mapping_ = static_cast<char*>(mapping);
+        FrameRing* aToB = new (mapping_) FrameRing{ size };
+        FrameRing* bToA = new (mapping_ + ringBytes_) FrameRing{ size };
+        a_ = std::make_unique<ShmTransport>(*bToA, *aToB);
+        b_ = std::make_unique<ShmTransport>(*aToB, *bToA);
+    }
+
+    ~ShmLoopback()
+    {
+        if (mapping_) ::munmap(mapping_, mappingBytes_);
+    }
+
+    ShmLoopback(const ShmLoopback&) = delete;
+    ShmLoopback& operator=(const ShmLoopback&) = delete;
+
+    bool IsValid() const { return mapping_ != nullptr; }
+    ShmTransport& A() { return *a_; }
+    ShmTransport& B() { return *b_; }
+
+private:
+    char* mapping_ = nullptr;
+    std::size_t ringBytes_ = 0;
+    std::size_t mappingBytes_ = 0;
+    std::unique_ptr<ShmTransport> a_;
+    std::unique_ptr<ShmTransport> b_;
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "Types.h"
+
+// One bit per OrderId over a sliding window of the most recent ids. Ids are
+// expected to rise roughly monotonically: inserting an id past the top of the
+// window slides the window up to it and clears the words it enters, so a set
+// fed by a rising id stream touches memory sequentially. Ids below the window
+// have been forgotten and their membership is unknown; ids above it were
+// never inserted.
+//
+// The window starts at InitialWords words on the first Insert and doubles,
+// up to the size it was constructed with, whenever sliding or an insert
+// below it would otherwise forget an id the set still holds. A quiet book
+// therefore keeps a small window, and a busy one grows to the full size.
+class SlidingIdSet
+{
+public:
+    static constexpr std::size_t DefaultIds = std::size_t{ 1 } << 20;
+    static constexpr std::size_t InitialWords = 64;
+
+    // The window covers at most ids rounded up to a power of two, at least 64.
+    explicit SlidingIdSet(std::size_t ids = DefaultIds)
+        : maxWords_{ std::bit_ceil(std::max<std::size_t>((ids + 63) / 64, 1)) }
+    {}
+
+    // Was orderId forgotten when the window slid past it?
+    bool Below(OrderId orderId) const { return Word(orderId) + bits_.size() < top_; }
+
+    bool Contains(OrderId orderId) const
+    {
+        const std::uint64_t word = Word(orderId);
+        if (word >= top_ || Below(orderId)) return false;
+        return (bits_[word & mask_] >> (orderId & 63)) & 1;
+    }
+
+    void Insert(OrderId orderId)
+    {
+        const std::uint64_t word = Word(orderId);
+        if (word >= top_) Advance(word + 1);
+        else if (Below(orderId)) {
+            if (top_ - word > maxWords_) return;
+            Resize(std::bit_ceil(top_ - word));
+        }
+        bits_[word & mask_] |= std::uint64_t{ 1 } << (orderId & 63);
+    }
+
+    void Erase(OrderId orderId)
+    {
+        const std::uint64_t word = Word(orderId);
+        if (word >= top_ || Below(orderId)) return;
+        bits_[word & mask_] &= ~(std::uint64_t{ 1 } << (orderId & 63));
+    }
+
+    std::size_t WindowIds() const { return bits_.size() * 64; }
+    std::size_t MemoryUsage() const { return bits_.capacity() * sizeof(std::uint64_t); }
+
+private:
+    static std::uint64_t Word(OrderId orderId) { return orderId >> 6; }
+
+    std::uint64_t Bottom() const { return top_ > bits_.size() ? top_ - bits_.size() : 0; }
+
+    // Slides the window so that its last word is top - 1, clearing the words
+    // it enters; a jump of a full window or more clears everything. Before
+    // held ids are slid past, the window grows to keep every one the full
+    // size can still reach.
+    void Advance(std::uint64_t top)
+    {
+        if (bits_.empty()) Resize(std::min(maxWords_, InitialWords));
+        if (bits_.size() < maxWords_ && top > bits_.size()) {
+            const std::uint64_t reach = top > maxWords_ ? top - maxWords_ : 0;
+            const std::uint64_t dropped = std::min<std::uint64_t>(top - bits_.size(), top_);
+            for (std::uint64_t word = std::max(Bottom(), reach); word < dropped; ++word) {
+                if (!bits_[word & mask_]) continue;
+                Resize(std::bit_ceil(top - word));
+                break;
+            }
+        }
+
+        const std::size_t words = bits_.size();
+        const std::uint64_t from = top - top_ > words ? top - words : top_;
+        for (std::uint64_t word = from; word < top; ++word) bits_[word & mask_] = 0;
+        top_ = top;
+    }
+
+    // Grows the window to words, keeping every word it covers now. Words it
+    // newly covers below are empty: ids are only forgotten while they are
+    // further below the top than the full window reaches.
+    void Resize(std::size_t words)
+    {
+        std::vector<std::uint64_t> bits(words, 0);
+        for (std::uint64_t word = Bottom(); word < top_; ++word) bits[word & (words - 1)] = bits_[word & mask_];
+        bits_.swap(bits);
+        mask_ = words - 1;
+    }
+
+    std::size_t maxWords_;
+    std::vector<std::uint64_t> bits_;
+    std::uint64_t mask_ = 0;
+    std::uint64_t top_ = 0;
+};
@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "MarketData.h"
+#include "Transport.h"
+#include "OrderBook.h"
+
+// Snapshot cadence is derived from the size of the previous snapshot so the
+// recovery channel stays within bandwidthBytesPerSec_: small books refresh
+// every minIntervalNs_, deep books back off towards maxIntervalNs_.
+struct SnapshotPolicy
+{
+    std::uint64_t bandwidthBytesPerSec_ = 1 << 20;
+    std::uint64_t minIntervalNs_ = 10'000'000;
+    std::uint64_t maxIntervalNs_ = 5'000'000'000;
+};
+
+struct SnapshotStats
+{
+    std::uint64_t snapshots_ = 0;
+    std::uint64_t packets_ = 0;
+    std::uint64_t bytes_ = 0;
+    std::uint64_t levels_ = 0;
+    std::uint64_t sendErrors_ = 0;
+};
+
+// Periodically publishes full-book snapshots on the recovery channel, tagged
+// with the delta-feed sequence they are consistent with. Must run on the
+// thread that mutates the book, between commands.
+class SnapshotService
+{
+public:
+    static constexpr std::size_t BatchSize = 32;
+
+    explicit SnapshotService(Transport& transport, SnapshotPolicy policy = {}, std::uint32_t channel = 1)
+        : transport_{ transport }
+        , policy_{ policy }
+        , channel_{ channel }
+        , intervalNs_{ policy.minIntervalNs_ }
+    {}
+
+    SnapshotService(const SnapshotService&) = delete;
+    SnapshotService& operator=(const SnapshotService&) = delete;
+
+    // Publishes a snapshot if the adaptive interval has elapsed. nextSequence
+    // is the sequence the delta feed will assign to its next delta.
+    bool Poll(const OrderBook& book, std::uint64_t nextSequence, std::uint64_t nowNs)
+    {
+        if (lastSnapshotNs_ && nowNs - lastSnapshotNs_ < intervalNs_) return false;
+        Publish(book, nextSequence, nowNs);
+        return true;
+    }
+
+    void Publish(const OrderBook& book, std::uint64_t nextSequence, std::uint64_t nowNs)
+    {
+        using namespace MarketData;
+
+        const OrderBookLevelInfos infos = book.GetOrderInfos();
+        const std::size_t levels = infos.GetBids().size() + infos.GetAsks().size();
+        const std::size_t fragments = std::max<std::size_t>(1, (levels + MaxLevelsPerPacket - 1) / MaxLevelsPerPacket);
+
+        packets_.resize(fragments);
+        sizes_.assign(fragments, 0);
+        ++snapshotId_;
+
+        std::size_t level = 0;
+        auto LevelAt = [&infos](std::size_t index) {
+            const auto& bids = infos.GetBids();
+            if (index < bids.size()) return SnapshotLevel{ static_cast<std::uint8_t>(Side::Buy), bids[index].price_, bids[index].quantity_ };
+            const auto& ask = infos.GetAsks()[index - bids.size()];
+            return SnapshotLevel{ static_cast<std::uint8_t>(Side::Sell), ask.price_, ask.quantity_ };
+        };
+
+        for (std::size_t fragment = 0; fragment < fragments; ++fragment)
+        {
+            const std::size_t count = std::min(MaxLevelsPerPacket, levels - level);
+            char* data = packets_[fragment].data();
+
+            const PacketHeader packetHeader{ nextSequence, static_cast<std::uint16_t>(count), 0, channel_, nowNs };
+            const SnapshotHeader snapshotHeader{ snapshotId_, static_cast<std::uint16_t>(fragment), static_cast<std::uint16_t>(fragments) };
+            std::memcpy(data, &packetHeader, sizeof(packetHeader));
+            std::memcpy(data + sizeof(packetHeader), &snapshotHeader, sizeof(snapshotHeader));
+
+            std::size_t size = sizeof(PacketHeader) + sizeof(SnapshotHeader);
+            for (std::size_t i = 0; i < count; ++i, ++level, size += sizeof(SnapshotLevel))
+            {
+                const SnapshotLevel entry = LevelAt(level);
+                std::memcpy(data + size, &entry, sizeof(entry));
+            }
+            sizes_[fragment] = size;
+        }
+
+        const std::uint64_t bytes = Send();
+        ++stats_.snapshots_;
+        stats_.levels_ += levels;
+
+        lastSnapshotNs_ = nowNs;
+        intervalNs_ = std::clamp<std::uint64_t>(bytes * 1'000'000'000ull / std::max<std::uint64_t>(1, policy_.bandwidthBytesPerSec_),
+            policy_.minIntervalNs_, policy_.maxIntervalNs_);
+    }
+
+    std::uint64_t IntervalNs() const { return intervalNs_; }
+    const SnapshotStats& Stats() const { return stats_; }
+
+private:
+    using Datagram = std::array<char, MarketData::MaxDatagramSize>;
+
+    std::uint64_t Send()
+    {
+        std::uint64_t bytes = 0;
+        std::array<Frame, BatchSize> frames;
+
+        for (std::size_t first = 0; first < packets_.size(); first += BatchSize)
+        {
+            const std::size_t count = std::min(BatchSize, packets_.size() - first);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                frames[i] = Frame{ packets_[first + i].data(), sizes_[first + i] };
+                bytes += sizes_[first + i];
+            }
+
+            const std::size_t sent = transport_.Send(std::span<const Frame>{ frames.data(), count });
+            stats_.packets_ += sent;
+            stats_.sendErrors_ += count - sent;
+        }
+        stats_.bytes_ += bytes;
+        return bytes;
+    }
+
+    Transport& transport_;
+    SnapshotPolicy policy_;
+    std::uint32_t channel_;
+
+    std::uint32_t snapshotId_ = 0;
+    std::uint64_t lastSnapshotNs_ = 0;
+    std::uint64_t intervalNs_;
+
+    std::vector<Datagram> packets_;
+    std::vector<std::size_t> sizes_;
+    SnapshotStats stats_;
+};
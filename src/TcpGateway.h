@@ -0,0 +1,401 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <vector>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "IngressQueue.h"
+#include "Protocol.h"
+
+// Outbound bytes for one connection, kept in fixed-size blocks so a flush can
+// hand every pending block to a single writev call.
+class OutputQueue
+{
+public:
+    static constexpr std::size_t BlockSize = 4096;
+    static constexpr int MaxIov = 64;
+
+    void append(const void* data, std::size_t length)
+    {
+        if (blocks_.empty() || BlockSize - blocks_.back()->end_ < length) {
+            if (spare_.empty()) spare_.push_back(std::make_unique<Block>());
+            blocks_.push_back(std::move(spare_.back()));
+            spare_.pop_back();
+            blocks_.back()->begin_ = 0;
+            blocks_.back()->end_ = 0;
+        }
+        Block& block = *blocks_.back();
+        std::memcpy(block.data_.data() + block.end_, data, length);
+        block.end_ += length;
+    }
+
+    bool empty() const { return blocks_.empty(); }
+
+    // Returns false on a fatal socket error. EAGAIN leaves the rest queued.
+    bool flush(int fd)
+    {
+        while (!blocks_.empty())
+        {
+            std::array<iovec, MaxIov> iov;
+            int count = 0;
+            for (; count < MaxIov && count < static_cast<int>(blocks_.size()); ++count) {
+                Block& block = *blocks_[count];
+                iov[count].iov_base = block.data_.data() + block.begin_;
+                iov[count].iov_len = block.end_ - block.begin_;
+            }
+
+            const ssize_t written = ::writev(fd, iov.data(), count);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+
+            std::size_t remaining = static_cast<std::size_t>(written);
+            std::size_t drained = 0;
+            while (drained < blocks_.size() && remaining) {
+                Block& block = *blocks_[drained];
+                const std::size_t chunk = std::min(remaining, block.end_ - block.begin_);
+                block.begin_ += chunk;
+                remaining -= chunk;
+                if (block.begin_ != block.end_) break;
+                ++drained;
+            }
+            for (std::size_t i = 0; i < drained; ++i) spare_.push_back(std::move(blocks_[i]));
+            blocks_.erase(blocks_.begin(), blocks_.begin() + static_cast<std::ptrdiff_t>(drained));
+
+            if (drained < static_cast<std::size_t>(count)) return true;
+        }
+        return true;
+    }
+
+private:
+    struct Block
+    {
+        std::array<char, BlockSize> data_;
+        std::size_t begin_ = 0;
+        std::size_t end_ = 0;
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks_;
+    std::vector<std::unique_ptr<Block>> spare_;
+};
+
+// Order-entry gateway over non-blocking TCP with edge-triggered epoll. Inbound
+// messages are decoded straight out of each session's receive buffer into
+// Commands on the ingress queue; execution reports are queued per session and
+// sent with writev on Flush. Everything runs on the thread that calls Poll.
+class TcpGateway
+{
+public:
+    static constexpr std::size_t ReceiveBufferSize = 64 * 1024;
+    static constexpr int MaxEvents = 256;
+
+    explicit TcpGateway(IngressQueue& ingress)
+        : ingress_{ ingress }
+    {}
+
+    ~TcpGateway()
+    {
+        for (auto& session : sessions_)
+            if (session && session->fd_ >= 0) ::close(session->fd_);
+        if (listenFd_ >= 0) ::close(listenFd_);
+        if (epollFd_ >= 0) ::close(epollFd_);
+    }
+
+    TcpGateway(const TcpGateway&) = delete;
+    TcpGateway& operator=(const TcpGateway&) = delete;
+
+    bool Listen(std::uint16_t port, const char* address = "127.0.0.1")
+    {
+        epollFd_ = ::epoll_create1(0);
+        if (epollFd_ < 0) return false;
+
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (listenFd_ < 0) return false;
+
+        int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (::inet_pton(AF_INET, address, &addr.sin_addr) != 1) return false;
+        if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return false;
+        if (::listen(listenFd_, SOMAXCONN) < 0) return false;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.u64 = ListenerTag;
+        return ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event) == 0;
+    }
+
+    // Waits up to timeoutMs for socket activity, accepting connections and
+    // decoding inbound messages. Returns the number of commands enqueued.
+    std::size_t Poll(int timeoutMs)
+    {
+        std::size_t enqueued = 0;
+
+        // Sessions left with unread or undecoded bytes because the ingress
+        // queue was full get serviced before we block on epoll again.
+        if (!backlog_.empty()) {
+            std::vector<std::uint32_t> backlog;
+            backlog.swap(backlog_);
+            for (auto sessionId : backlog) {
+                if (Session* session = Find(sessionId)) {
+                    session->backlogged_ = false;
+                    enqueued += Receive(*session);
+                }
+            }
+            timeoutMs = 0;
+        }
+
+        std::array<epoll_event, MaxEvents> events;
+        const int ready = ::epoll_wait(epollFd_, events.data(), MaxEvents, timeoutMs);
+        for (int i = 0; i < ready; ++i)
+        {
+            const epoll_event& event = events[i];
+            if (event.data.u64 == ListenerTag) {
+                Accept();
+                continue;
+            }
+
+            Session* session = Find(static_cast<std::uint32_t>(event.data.u64));
+            if (!session) continue;
+
+            if (event.events & EPOLLERR) {
+                Close(*session);
+                continue;
+            }
+            if (event.events & EPOLLOUT) {
+                if (!session->output_.flush(session->fd_)) {
+                    Close(*session);
+                    continue;
+                }
+            }
+            if (event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) enqueued += Receive(*session);
+        }
+        return enqueued;
+    }
+
+    void OnExecutionReport(std::uint32_t sessionId, const Protocol::ExecutionReportMessage& report)
+    {
+        Queue(sessionId, &report, sizeof(report));
+    }
+
+    void OnFill(std::uint32_t sessionId, const Protocol::FillMessage& fill)
+    {
+        Queue(sessionId, &fill, sizeof(fill));
+    }
+
+    // Sends everything queued since the last flush, one writev per session.
+    void Flush()
+    {
+        for (auto sessionId : dirty_)
+        {
+            Session* session = Find(sessionId);
+            if (!session) continue;
+            session->dirty_ = false;
+            if (!session->output_.flush(session->fd_)) Close(*session);
+        }
+        dirty_.clear();
+    }
+
+    std::size_t SessionCount() const { return sessionCount_; }
+
+private:
+    static constexpr std::uint64_t ListenerTag = ~std::uint64_t{ 0 };
+
+    struct Session
+    {
+        int fd_ = -1;
+        std::uint32_t id_ = 0;
+        std::size_t received_ = 0;
+        bool dirty_ = false;
+        bool backlogged_ = false;
+        bool malformed_ = false;
+        std::unique_ptr<char[]> input_{ new char[ReceiveBufferSize] };
+        OutputQueue output_;
+    };
+
+    // Session ids carry the slot in the low 16 bits and a generation in the
+    // high 16 so reports for a closed connection are never misrouted.
+    static std::uint32_t Slot(std::uint32_t sessionId) { return sessionId & 0xFFFF; }
+
+    Session* Find(std::uint32_t sessionId)
+    {
+        const std::uint32_t slot = Slot(sessionId);
+        if (slot >= sessions_.size() || !sessions_[slot]) return nullptr;
+        Session* session = sessions_[slot].get();
+        return session->id_ == sessionId ? session : nullptr;
+    }
+
+    void Accept()
+    {
+        while (true)
+        {
+            const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            std::uint32_t slot;
+            if (!freeSlots_.empty()) {
+                slot = freeSlots_.back();
+                freeSlots_.pop_back();
+            } else if (sessions_.size() <= 0xFFFF) {
+                slot = static_cast<std::uint32_t>(sessions_.size());
+                sessions_.emplace_back();
+                generations_.push_back(0);
+            } else {
+                ::close(fd);
+                continue;
+            }
+
+            auto session = std::make_unique<Session>();
+            session->fd_ = fd;
+            session->id_ = (static_cast<std::uint32_t>(++generations_[slot]) << 16) | slot;
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.u64 = session->id_;
+            if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+                ::close(fd);
+                freeSlots_.push_back(slot);
+                continue;
+            }
+
+            sessions_[slot] = std::move(session);
+            ++sessionCount_;
+        }
+    }
+
+    // Edge-triggered: keep reading until EAGAIN, unless the receive buffer or
+    // the ingress queue fills up first, in which case the session is parked on
+    // the backlog and resumed on the next Poll.
+    std::size_t Receive(Session& session)
+    {
+        std::size_t enqueued = 0;
+        bool peerClosed = false;
+        while (true)
+        {
+            enqueued += DecodeInput(session);
+            if (session.malformed_) {
+                peerClosed = true;
+                break;
+            }
+            if (session.backlogged_) return enqueued;
+
+            if (session.received_ == ReceiveBufferSize) {
+                Park(session);
+                return enqueued;
+            }
+
+            const ssize_t bytes = ::recv(session.fd_, session.input_.get() + session.received_,
+                ReceiveBufferSize - session.received_, 0);
+            if (bytes > 0) {
+                session.received_ += static_cast<std::size_t>(bytes);
+                continue;
+            }
+            if (bytes < 0 && errno == EINTR) continue;
+            if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            peerClosed = true;
+            break;
+        }
+
+        if (peerClosed) Close(session);
+        return enqueued;
+    }
+
+    std::size_t DecodeInput(Session& session)
+    {
+        using namespace Protocol;
+
+        std::size_t enqueued = 0;
+        std::size_t offset = 0;
+        const char* data = session.input_.get();
+
+        while (true)
+        {
+            MessageHeader header;
+            const ParseResult result = PeekMessage(data + offset, session.received_ - offset, header);
+            if (result == ParseResult::NeedMore) break;
+            if (result == ParseResult::Malformed) {
+                session.malformed_ = true;
+                return enqueued;
+            }
+
+            Command command;
+            if (!ToCommand(header, data + offset, session.id_, command)) {
+                session.malformed_ = true;
+                return enqueued;
+            }
+
+            if (!ingress_.try_push(command)) {
+                Park(session);
+                break;
+            }
+            offset += header.length_;
+            ++enqueued;
+        }
+
+        if (offset) {
+            std::memmove(session.input_.get(), data + offset, session.received_ - offset);
+            session.received_ -= offset;
+        }
+        return enqueued;
+    }
+
+    void Park(Session& session)
+    {
+        if (session.backlogged_) return;
+        session.backlogged_ = true;
+        backlog_.push_back(session.id_);
+    }
+
+    void Queue(std::uint32_t sessionId, const void* data, std::size_t length)
+    {
+        Session* session = Find(sessionId);
+        if (!session) return;
+        session->output_.append(data, length);
+        if (!session->dirty_) {
+            session->dirty_ = true;
+            dirty_.push_back(sessionId);
+        }
+    }
+
+    void Close(Session& session)
+    {
+        const std::uint32_t slot = Slot(session.id_);
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, session.fd_, nullptr);
+        ::close(session.fd_);
+        sessions_[slot].reset();
+        freeSlots_.push_back(slot);
+        --sessionCount_;
+    }
+
+    IngressQueue& ingress_;
+    int epollFd_ = -1;
+    int listenFd_ = -1;
+
+    std::vector<std::unique_ptr<Session>> sessions_;
+    std::vector<std::uint16_t> generations_;
+    std::vector<std::uint32_t> freeSlots_;
+    std::vector<std::uint32_t> dirty_;
+    std::vector<std::uint32_t> backlog_;
+    std::size_t sessionCount_ = 0;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <span>
+#include <cstddef>
+
+// A frame is one datagram-sized unit handed between the application and a
+// transport. Received frames point into transport-owned storage that stays
+// valid until the next Receive on the same transport.
+struct Frame
+{
+    const char* data_ = nullptr;
+    std::size_t length_ = 0;
+};
+
+// Poll-mode, batch-oriented I/O. Neither call blocks: Receive returns what is
+// available now (possibly nothing) and Send returns how many frames were
+// accepted. Implementations may be kernel sockets, shared memory, or a
+// kernel-bypass NIC queue; callers only ever see bursts of frames.
+class Transport
+{
+public:
+    static constexpr std::size_t MaxFrameSize = 2048;
+
+    virtual ~Transport() = default;
+
+    virtual std::size_t Receive(std::span<Frame> frames) = 0;
+    virtual std::size_t Send(std::span<const Frame> frames) = 0;
+};
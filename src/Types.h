@@ -1,13 +1,13 @@
 #pragma once
 #include <cstdint>
 
-enum class OrderType
+enum class OrderType : std::uint8_t
 {
     GoodTillCancel,
     FillAndKill
 };
 
-enum class Side
+enum class Side : std::uint8_t
 {
     Buy,
     Sell
@@ -15,4 +15,19 @@ enum class Side
 
 using Price = std::int32_t;
 using Quantity = std::uint32_t;
-using OrderId = std::uint64_t;
\ No newline at end of file
+using OrderId = std::uint64_t;
+using InstrumentId = std::uint32_t;
+
+// Why the book refused an operation. None means the operation was applied,
+// even if it produced no trades.
+enum class ErrorCode : std::uint8_t
+{
+    None,
+    DuplicateOrderId,
+    PoolExhausted,
+    UnknownOrderId,
+    UnknownInstrument,
+    InvalidPrice,
+    PriceOutOfBand,
+    InvalidQuantity
+};
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+#include <array>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Transport.h"
+
+// Transport over a non-blocking UDP socket, moving each burst with a single
+// recvmmsg or sendmmsg. Bind for the receiving side (joining the group when
+// the address is multicast), Connect for the sending side.
+class UdpTransport : public Transport
+{
+public:
+    static constexpr std::size_t BatchSize = 32;
+
+    ~UdpTransport() override
+    {
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    UdpTransport() = default;
+    UdpTransport(const UdpTransport&) = delete;
+    UdpTransport& operator=(const UdpTransport&) = delete;
+
+    bool Bind(const char* address, std::uint16_t port)
+    {
+        if (!Create()) return false;
+
+        int one = 1;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        int receiveBuffer = 8 << 20;
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+        sockaddr_in addr{};
+        if (!Resolve(address, port, addr)) return false;
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return false;
+
+        if (IN_MULTICAST(ntohl(addr.sin_addr.s_addr))) {
+            ip_mreq membership{};
+            membership.imr_multiaddr = addr.sin_addr;
+            membership.imr_interface.s_addr = htonl(INADDR_ANY);
+            if (::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) return false;
+        }
+        return true;
+    }
+
+    bool Connect(const char* address, std::uint16_t port)
+    {
+        if (!Create()) return false;
+
+        sockaddr_in addr{};
+        if (!Resolve(address, port, addr)) return false;
+
+        if (IN_MULTICAST(ntohl(addr.sin_addr.s_addr))) {
+            unsigned char loop = 1;
+            unsigned char ttl = 1;
+            ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+            ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        }
+
+        int sendBuffer = 4 << 20;
+        ::setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+
+        return ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+
+    std::size_t Receive(std::span<Frame> frames) override
+    {
+        const std::size_t count = std::min(frames.size(), BatchSize);
+        std::array<mmsghdr, BatchSize> messages{};
+        std::array<iovec, BatchSize> iov{};
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            iov[i].iov_base = buffers_[i].data();
+            iov[i].iov_len = buffers_[i].size();
+            messages[i].msg_hdr.msg_iov = &iov[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int received = ::recvmmsg(fd_, messages.data(), static_cast<unsigned>(count), MSG_DONTWAIT, nullptr);
+        if (received <= 0) return 0;
+
+        for (int i = 0; i < received; ++i)
+            frames[i] = Frame{ buffers_[i].data(), static_cast<std::size_t>(messages[i].msg_len) };
+        return static_cast<std::size_t>(received);
+    }
+
+    std::size_t Send(std::span<const Frame> frames) override
+    {
+        std::size_t sent = 0;
+        while (sent < frames.size())
+        {
+            const std::size_t count = std::min(frames.size() - sent, BatchSize);
+            std::array<mmsghdr, BatchSize> messages{};
+            std::array<iovec, BatchSize> iov{};
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                iov[i].iov_base = const_cast<char*>(frames[sent + i].data_);
+                iov[i].iov_len = frames[sent + i].length_;
+                messages[i].msg_hdr.msg_iov = &iov[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            const int result = ::sendmmsg(fd_, messages.data(), static_cast<unsigned>(count), MSG_DONTWAIT);
+            if (result < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            sent += static_cast<std::size_t>(result);
+            if (static_cast<std::size_t>(result) < count) break;
+        }
+        return sent;
+    }
+
+private:
+    bool Create()
+    {
+        fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        return fd_ >= 0;
+    }
+
+    static bool Resolve(const char* address, std::uint16_t port, sockaddr_in& addr)
+    {
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        return ::inet_pton(AF_INET, address, &addr.sin_addr) == 1;
+    }
+
+    int fd_ = -1;
+    std::array<std::array<char, MaxFrameSize>, BatchSize> buffers_;
+};
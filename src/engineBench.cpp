@@ -0,0 +1,124 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+
+#include "OrderBook.h"
+#include "IngressQueue.h"
+#include "BookEngine.h"
+#include "MarketDataPublisher.h"
+#include "MarketDataReceiver.h"
+#include "ShmTransport.h"
+
+// Runs the fully polled BookEngine against an order-entry client and a market
+// data consumer connected through shared-memory loopback transports. Client,
+// engine and consumer are stepped on one thread, so the timings are pure
+// processing cost with no system calls and no cross-core handoff.
+int main(int argc, char** argv)
+{
+    using namespace Protocol;
+    using Clock = std::chrono::steady_clock;
+
+    const int NUM_ORDERS = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    const int ORDERS_PER_BURST = argc > 2 ? std::max(1, std::atoi(argv[2])) : 64;
+
+    std::vector<NewOrderMessage> orders;
+    orders.reserve(NUM_ORDERS);
+
+    std::mt19937 rng(126456u);
+    std::uniform_int_distribution<int> qty_dist(1, 50);
+    std::bernoulli_distribution fak_dist(0.05);
+    std::uniform_int_distribution<int> offset_dist(0, 5);
+    std::normal_distribution<double> mid_step_dist(0.0, 0.25);
+
+    Price mid = 100;
+    for (int i = 0; i < NUM_ORDERS; ++i) {
+        mid = std::max<Price>(1, mid + static_cast<Price>(std::lround(mid_step_dist(rng))));
+        const Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        const int offset = offset_dist(rng);
+        const Price price = side == Side::Buy ? std::max<Price>(1, mid - offset) : mid + offset;
+        const OrderType type = fak_dist(rng) ? OrderType::FillAndKill : OrderType::GoodTillCancel;
+        orders.push_back(NewOrderMessage{ MakeHeader<NewOrderMessage>(MessageType::NewOrder),
+            static_cast<OrderId>(i) + 1, price, static_cast<Quantity>(qty_dist(rng)),
+            static_cast<std::uint8_t>(side), static_cast<std::uint8_t>(type) });
+    }
+
+    ShmLoopback orderEntry{ 1024 };
+    ShmLoopback marketData{ 4096 };
+    if (!orderEntry.IsValid() || !marketData.IsValid()) {
+        std::cerr << "Failed to map shared memory" << std::endl;
+        return 1;
+    }
+
+    OrderBook orderbook;
+    orderbook.Preheat(static_cast<std::size_t>(NUM_ORDERS));
+    IngressQueue ingress{ 4096 };
+    MarketDataPublisher publisher{ marketData.A() };
+    SeqLock<TopOfBook> topOfBook;
+    BookEngine engine{ orderbook, ingress, &publisher, &topOfBook };
+    engine.AddSession(orderEntry.A());
+
+    Transport& client = orderEntry.B();
+    MarketDataReceiver consumer{ marketData.B() };
+
+    const std::size_t ordersPerFrame = Transport::MaxFrameSize / sizeof(NewOrderMessage);
+    std::vector<long long> burst_ns;
+    long long reports = 0;
+    long long fills = 0;
+    std::uint64_t deltas = 0;
+    auto OnDelta = [&deltas](std::uint64_t, const MarketData::BookDelta&) { ++deltas; };
+
+    const auto start = Clock::now();
+    for (int next = 0; next < NUM_ORDERS; next += ORDERS_PER_BURST)
+    {
+        const auto burstStart = Clock::now();
+        const int count = std::min(ORDERS_PER_BURST, NUM_ORDERS - next);
+
+        std::vector<Frame> frames;
+        for (int i = 0; i < count; i += static_cast<int>(ordersPerFrame)) {
+            const std::size_t inFrame = std::min<std::size_t>(ordersPerFrame, static_cast<std::size_t>(count - i));
+            frames.push_back(Frame{ reinterpret_cast<const char*>(&orders[next + i]), inFrame * sizeof(NewOrderMessage) });
+        }
+        client.Send(frames);
+
+        long long expected = reports + count;
+        while (reports < expected)
+        {
+            engine.Poll();
+            std::array<Frame, BookEngine::BurstSize> received;
+            const std::size_t n = client.Receive(received);
+            for (std::size_t f = 0; f < n; ++f) {
+                std::size_t offset = 0;
+                MessageHeader header;
+                while (PeekMessage(received[f].data_ + offset, received[f].length_ - offset, header) == ParseResult::Complete) {
+                    if (header.type_ == MessageType::ExecutionReport) ++reports;
+                    else ++fills;
+                    offset += header.length_;
+                }
+            }
+            while (consumer.Poll(OnDelta)) {}
+        }
+        burst_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - burstStart).count());
+    }
+    const auto end = Clock::now();
+
+    std::sort(burst_ns.begin(), burst_ns.end());
+    const double total_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+    std::cout << "------------------------------------------------" << std::endl;
+    std::cout << "Orders: " << NUM_ORDERS << " in bursts of " << ORDERS_PER_BURST << std::endl;
+    std::cout << "Execution reports: " << reports << ", fills: " << fills << std::endl;
+    std::cout << "Market data deltas received: " << deltas << " (gaps: " << consumer.Stats().gaps_ << ")" << std::endl;
+    const TopOfBook top = topOfBook.Load();
+    std::cout << "Top of book: " << top.bidQuantity_ << " @ " << top.bidPrice_ << " / " << top.askQuantity_ << " @ " << top.askPrice_
+        << " (" << topOfBook.Version() << " updates)" << std::endl;
+    std::cout << "Burst round trip (p50): " << burst_ns[burst_ns.size() / 2] << " ns" << std::endl;
+    std::cout << "Burst round trip (p99): " << burst_ns[static_cast<std::size_t>(0.99 * (burst_ns.size() - 1))] << " ns" << std::endl;
+    std::cout << "Average cost per order (end to end): " << total_ns / NUM_ORDERS << " ns" << std::endl;
+    std::cout << "Throughput: " << static_cast<long long>(NUM_ORDERS / (total_ns / 1e9)) << " orders/sec" << std::endl;
+    std::cout << "------------------------------------------------" << std::endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+
+#include "OrderBook.h"
+#include "IngressQueue.h"
+#include "Dispatcher.h"
+#include "EventLoop.h"
+#include "MarketData.h"
+
+// Feeds a matching thread with a trickle of orders (one every GAP_US) under
+// each backoff mode and reports the wake-up latency from enqueue to
+// execution, the CPU time the matching thread burned, and its busy/idle split.
+namespace
+{
+    struct LatencySink
+    {
+        const std::vector<std::uint64_t>& sentNs_;
+        std::vector<std::uint64_t>& latencyNs_;
+
+        void OnExecutionReport(std::uint32_t, const Protocol::ExecutionReportMessage& report)
+        {
+            latencyNs_.push_back(MarketData::NowNs() - sentNs_[report.orderId_ - 1]);
+        }
+        void OnFill(std::uint32_t, const Protocol::FillMessage&) {}
+    };
+
+    double ThreadCpuMs()
+    {
+        timespec ts{};
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int NUM_ORDERS = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int GAP_US = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    struct Mode {
+        const char* name;
+        BackoffPolicy policy;
+    };
+    const Mode modes[] = {
+        { "spin", BackoffPolicy::Spin() },
+        { "pause", BackoffPolicy::Pause() },
+        { "yield", BackoffPolicy::Yield() },
+        { "futex", BackoffPolicy::Sleep() },
+        { "adaptive", BackoffPolicy{} },
+    };
+
+    std::cout << "Orders: " << NUM_ORDERS << ", one every " << GAP_US << " us" << std::endl;
+    std::cout << "------------------------------------------------" << std::endl;
+
+    for (const auto& mode : modes)
+    {
+        OrderBook orderbook;
+        IngressQueue ingress{ 1024 };
+        Waker waker;
+        EventLoop loop{ mode.policy, waker };
+
+        std::vector<std::uint64_t> sentNs(NUM_ORDERS);
+        std::vector<std::uint64_t> latencyNs;
+        latencyNs.reserve(NUM_ORDERS);
+        LatencySink sink{ sentNs, latencyNs };
+
+        double cpuMs = 0;
+        std::thread matching([&]() {
+            const double cpuStart = ThreadCpuMs();
+            loop.Run([&]() { return DrainIngress(ingress, orderbook, sink, 64); });
+            cpuMs = ThreadCpuMs() - cpuStart;
+        });
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_ORDERS; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(GAP_US));
+            const Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+            const Price price = side == Side::Buy ? 99 : 101;
+            sentNs[i] = MarketData::NowNs();
+            Command command{ CommandType::Add, OrderType::GoodTillCancel, side, 0, static_cast<OrderId>(i) + 1, price, 1, 0 };
+            while (!ingress.try_push(command)) CpuRelax();
+            waker.Notify();
+        }
+        while (!ingress.empty()) std::this_thread::yield();
+        const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        loop.Stop();
+        matching.join();
+
+        std::sort(latencyNs.begin(), latencyNs.end());
+        const EventLoopStats& stats = loop.Stats();
+        std::cout << "Mode: " << mode.name << std::endl;
+        std::cout << "  Wake-up latency (p50): " << latencyNs[latencyNs.size() / 2] << " ns" << std::endl;
+        std::cout << "  Wake-up latency (p99): " << latencyNs[static_cast<std::size_t>(0.99 * (latencyNs.size() - 1))] << " ns" << std::endl;
+        std::cout << "  Matching thread CPU: " << cpuMs << " ms of " << wallMs << " ms wall" << std::endl;
+        std::cout << "  Busy cycles: " << stats.BusyFraction() * 100.0 << "%"
+                  << " (polls busy " << stats.busyPolls_ << ", idle " << stats.idlePolls_
+                  << "; pauses " << stats.pauses_ << ", yields " << stats.yields_ << ", sleeps " << stats.sleeps_ << ")" << std::endl;
+    }
+    std::cout << "------------------------------------------------" << std::endl;
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <iostream>
+#include <csignal>
+#include <cstdlib>
+
+#include "OrderBook.h"
+#include "IngressQueue.h"
+#include "Dispatcher.h"
+#include "TcpGateway.h"
+
+namespace
+{
+    volatile std::sig_atomic_t running = 1;
+    void Stop(int) { running = 0; }
+}
+
+int main(int argc, char** argv)
+{
+    const std::uint16_t port = static_cast<std::uint16_t>(argc > 1 ? std::atoi(argv[1]) : 9000);
+
+    std::signal(SIGINT, Stop);
+    std::signal(SIGTERM, Stop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    OrderBook orderbook;
+    orderbook.Preheat(1000000);
+    IngressQueue ingress{ 65536 };
+    TcpGateway gateway{ ingress };
+
+    if (!gateway.Listen(port)) {
+        std::cerr << "Failed to listen on 127.0.0.1:" << port << std::endl;
+        return 1;
+    }
+    std::cout << "Gateway listening on 127.0.0.1:" << port << std::endl;
+
+    while (running)
+    {
+        gateway.Poll(ingress.empty() ? 100 : 0);
+        DrainIngress(ingress, orderbook, gateway, ingress.capacity());
+        gateway.Flush();
+    }
+
+    std::cout << "Shutting down, resting orders: " << orderbook.Size() << std::endl;
+    return 0;
+}
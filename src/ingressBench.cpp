@@ -0,0 +1,131 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+#include "OrderBook.h"
+#include "IngressQueue.h"
+#include "Dispatcher.h"
+#include "MarketData.h"
+
+// A market maker rests quotes on both sides, then a burst of aggressive
+// FillAndKill orders arrives and the maker tries to pull every quote while
+// the burst is still being queued. The whole burst is queued before the
+// matching thread drains it, as when a burst outruns the matcher. The same
+// stream runs through a single FIFO lane and through the priority lanes; the
+// benchmark reports how long the cancels waited from the start of the drain
+// to their execution reports, and how much of the maker's quantity was picked
+// off before its cancels ran. Other participants' stale cancels, for orders
+// of the last few rounds that have already filled or been cancelled, are
+// mixed into the burst.
+namespace
+{
+    constexpr std::uint32_t MakerSession = 1;
+    constexpr std::uint32_t FloodSession = 2;
+    constexpr std::uint32_t StaleSession = 3;
+
+    struct BurstSink
+    {
+        std::uint64_t drainStartNs_ = 0;
+        std::vector<std::uint64_t> cancelLatencyNs_;
+        std::uint64_t pickedOff_ = 0;
+        bool cancelling_ = false;
+
+        void OnExecutionReport(std::uint32_t sessionId, const Protocol::ExecutionReportMessage&)
+        {
+            if (cancelling_ && sessionId == MakerSession)
+                cancelLatencyNs_.push_back(MarketData::NowNs() - drainStartNs_);
+        }
+        void OnFill(std::uint32_t sessionId, const Protocol::FillMessage& fill)
+        {
+            if (sessionId == FloodSession) pickedOff_ += fill.quantity_;
+        }
+    };
+}
+
+int main(int argc, char** argv)
+{
+    const int ROUNDS = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int FLOOD = argc > 2 ? std::atoi(argv[2]) : 2048;
+    // One stale cancel per this many adds in the burst; 0 sends none.
+    const int STALE_EVERY = argc > 3 ? std::atoi(argv[3]) : 8;
+    const int QUOTES = 20;
+    const Quantity QUOTE_QUANTITY = 100;
+    // The maker's cancels are spread over the first eighth of the burst.
+    const int CANCEL_STRIDE = std::max(1, FLOOD / (8 * QUOTES));
+
+    struct Mode {
+        const char* name;
+        std::size_t fairnessWindow;
+    };
+    const Mode modes[] = {
+        { "single FIFO lane", 0 },
+        { "priority lanes", IngressQueue::DefaultFairnessWindow },
+    };
+
+    std::cout << "Rounds: " << ROUNDS << ", adds per burst: " << FLOOD << ", maker quotes: " << QUOTES
+              << ", stale cancels: " << (STALE_EVERY > 0 ? FLOOD / STALE_EVERY : 0) << std::endl;
+    std::cout << "------------------------------------------------" << std::endl;
+
+    for (const auto& mode : modes)
+    {
+        OrderBook orderbook;
+        orderbook.Preheat(static_cast<std::size_t>(QUOTES) * 4);
+        IngressQueue ingress{ static_cast<std::size_t>(2 * FLOOD + QUOTES), mode.fairnessWindow };
+        BurstSink sink;
+        sink.cancelLatencyNs_.reserve(static_cast<std::size_t>(ROUNDS) * QUOTES);
+
+        OrderId nextId = 1;
+        std::mt19937_64 rng(2024u);
+        auto Push = [&ingress](const Command& command) {
+            if (!ingress.try_push(command)) std::abort();
+        };
+
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            const OrderId firstMakerId = nextId;
+            for (int q = 0; q < QUOTES; ++q) {
+                const Side side = q % 2 ? Side::Sell : Side::Buy;
+                const Price price = side == Side::Buy ? 99 - q / 2 : 101 + q / 2;
+                Push(Command{ CommandType::Add, OrderType::GoodTillCancel, side, MakerSession, nextId++, price, QUOTE_QUANTITY, 0 });
+            }
+            sink.cancelling_ = false;
+            DrainIngress(ingress, orderbook, sink, ingress.capacity());
+
+            for (int i = 0; i < FLOOD; ++i) {
+                const Side side = i % 2 ? Side::Buy : Side::Sell;
+                const Price price = side == Side::Buy ? 101 + QUOTES : 99 - QUOTES;
+                Push(Command{ CommandType::Add, OrderType::FillAndKill, side, FloodSession, nextId++, price, 1, 0 });
+                if (i % CANCEL_STRIDE == 0 && i / CANCEL_STRIDE < QUOTES) {
+                    const OrderId quoteId = firstMakerId + static_cast<OrderId>(i / CANCEL_STRIDE);
+                    Push(Command{ CommandType::Cancel, OrderType::GoodTillCancel, Side::Buy, MakerSession, quoteId, 0, 0, 0 });
+                }
+                if (STALE_EVERY > 0 && i % STALE_EVERY == 0 && firstMakerId > 1) {
+                    const OrderId recent = std::min<OrderId>(firstMakerId - 1, 8 * static_cast<OrderId>(FLOOD + QUOTES));
+                    const OrderId staleId = firstMakerId - 1 - rng() % recent;
+                    Push(Command{ CommandType::Cancel, OrderType::GoodTillCancel, Side::Buy, StaleSession, staleId, 0, 0, 0 });
+                }
+            }
+            sink.cancelling_ = true;
+            sink.drainStartNs_ = MarketData::NowNs();
+            DrainIngress(ingress, orderbook, sink, ingress.capacity());
+        }
+
+        std::vector<std::uint64_t>& latencyNs = sink.cancelLatencyNs_;
+        std::sort(latencyNs.begin(), latencyNs.end());
+        const double quoted = static_cast<double>(ROUNDS) * QUOTES * QUOTE_QUANTITY;
+        std::cout << "Mode: " << mode.name << std::endl;
+        std::cout << "  Cancel latency (p50): " << latencyNs[latencyNs.size() / 2] << " ns" << std::endl;
+        std::cout << "  Cancel latency (p99): " << latencyNs[static_cast<std::size_t>(0.99 * (latencyNs.size() - 1))] << " ns" << std::endl;
+        std::cout << "  Maker quantity picked off: " << 100.0 * static_cast<double>(sink.pickedOff_) / quoted << "%" << std::endl;
+        for (const IngressLane lane : { IngressLane::Priority, IngressLane::Order }) {
+            const IngressLaneStats& stats = ingress.Stats(lane);
+            std::cout << "  " << (lane == IngressLane::Priority ? "Priority" : "Order") << " lane: "
+                      << stats.commands_ << " commands, sampled latency mean " << stats.MeanLatencyNs()
+                      << " ns, max " << stats.maxLatencyNs_ << " ns, max depth " << stats.maxDepth_ << std::endl;
+        }
+    }
+    std::cout << "------------------------------------------------" << std::endl;
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Protocol.h"
+
+// Drives a gateway on localhost with the same random-walk order flow as the
+// book benchmark and reports per-order round-trip latency, measured from the
+// send of a NewOrder to the receipt of its ExecutionReport.
+int main(int argc, char** argv)
+{
+    using namespace Protocol;
+    using Clock = std::chrono::steady_clock;
+
+    const std::uint16_t port = static_cast<std::uint16_t>(argc > 1 ? std::atoi(argv[1]) : 9000);
+    const int NUM_ORDERS = argc > 2 ? std::atoi(argv[2]) : 200000;
+    const int WINDOW = argc > 3 ? std::max(1, std::atoi(argv[3])) : 1;
+    const OrderId ID_BASE = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Failed to connect to 127.0.0.1:" << port << std::endl;
+        return 1;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    std::vector<NewOrderMessage> orders;
+    orders.reserve(NUM_ORDERS);
+
+    std::mt19937 rng(126456u);
+    std::uniform_int_distribution<int> qty_dist(1, 50);
+    std::bernoulli_distribution fak_dist(0.05);
+    std::uniform_int_distribution<int> offset_dist(0, 5);
+    std::normal_distribution<double> mid_step_dist(0.0, 0.25);
+
+    Price mid = 100;
+    for (int i = 0; i < NUM_ORDERS; ++i) {
+        mid = std::max<Price>(1, mid + static_cast<Price>(std::lround(mid_step_dist(rng))));
+        const Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        const int offset = offset_dist(rng);
+        const Price price = side == Side::Buy ? std::max<Price>(1, mid - offset) : mid + offset;
+        const OrderType type = fak_dist(rng) ? OrderType::FillAndKill : OrderType::GoodTillCancel;
+
+        orders.push_back(NewOrderMessage{ MakeHeader<NewOrderMessage>(MessageType::NewOrder),
+            ID_BASE + static_cast<OrderId>(i), price, static_cast<Quantity>(qty_dist(rng)),
+            static_cast<std::uint8_t>(side), static_cast<std::uint8_t>(type) });
+    }
+
+    std::vector<Clock::time_point> sent(NUM_ORDERS);
+    std::vector<long long> rtt_ns;
+    rtt_ns.reserve(NUM_ORDERS);
+
+    std::vector<char> input(1 << 16);
+    std::size_t received = 0;
+    long long fills = 0;
+    int next = 0;
+    int inFlight = 0;
+
+    const auto start = Clock::now();
+    while (static_cast<int>(rtt_ns.size()) < NUM_ORDERS)
+    {
+        const int toSend = std::min(WINDOW - inFlight, NUM_ORDERS - next);
+        if (toSend > 0) {
+            const auto now = Clock::now();
+            for (int i = 0; i < toSend; ++i) sent[next + i] = now;
+            const char* data = reinterpret_cast<const char*>(&orders[next]);
+            std::size_t length = sizeof(NewOrderMessage) * static_cast<std::size_t>(toSend);
+            while (length) {
+                const ssize_t written = ::send(fd, data, length, 0);
+                if (written <= 0) { std::cerr << "send failed" << std::endl; return 1; }
+                data += written;
+                length -= static_cast<std::size_t>(written);
+            }
+            next += toSend;
+            inFlight += toSend;
+        }
+
+        const ssize_t bytes = ::recv(fd, input.data() + received, input.size() - received, 0);
+        if (bytes <= 0) { std::cerr << "connection closed by gateway" << std::endl; return 1; }
+        received += static_cast<std::size_t>(bytes);
+
+        const auto now = Clock::now();
+        std::size_t offset = 0;
+        MessageHeader header;
+        while (PeekMessage(input.data() + offset, received - offset, header) == ParseResult::Complete)
+        {
+            if (header.type_ == MessageType::ExecutionReport) {
+                const auto report = Decode<ExecutionReportMessage>(input.data() + offset);
+                const auto index = static_cast<std::size_t>(report.orderId_ - ID_BASE);
+                rtt_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - sent[index]).count());
+                --inFlight;
+            } else if (header.type_ == MessageType::Fill) {
+                ++fills;
+            }
+            offset += header.length_;
+        }
+        std::memmove(input.data(), input.data() + offset, received - offset);
+        received -= offset;
+    }
+    const auto end = Clock::now();
+    ::close(fd);
+
+    std::sort(rtt_ns.begin(), rtt_ns.end());
+    auto percentile = [&rtt_ns](double p) { return rtt_ns[static_cast<std::size_t>(p * (rtt_ns.size() - 1))]; };
+    const double total_s = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "------------------------------------------------" << std::endl;
+    std::cout << "Orders: " << NUM_ORDERS << " (window " << WINDOW << ")" << std::endl;
+    std::cout << "Fills received: " << fills << std::endl;
+    std::cout << "Round trip (min): " << rtt_ns.front() << " ns" << std::endl;
+    std::cout << "Round trip (p50): " << percentile(0.50) << " ns" << std::endl;
+    std::cout << "Round trip (p99): " << percentile(0.99) << " ns" << std::endl;
+    std::cout << "Round trip (p99.9): " << percentile(0.999) << " ns" << std::endl;
+    std::cout << "Round trip (max): " << rtt_ns.back() << " ns" << std::endl;
+    std::cout << "Throughput: " << static_cast<long long>(NUM_ORDERS / total_s) << " orders/sec" << std::endl;
+    std::cout << "------------------------------------------------" << std::endl;
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+
+#include "OrderBook.h"
+#include "MarketDataPublisher.h"
+#include "MarketDataReceiver.h"
+#include "SnapshotService.h"
+#include "BookRecovery.h"
+#include "UdpTransport.h"
+#include "ShmTransport.h"
+
+// Replays the benchmark order flow through a book, publishes the resulting
+// deltas over UDP and consumes them on loopback from a second thread. Reports
+// publish rate, gaps seen by the receiver and the latency from the book event
+// to the datagram being sent and received. The consumer joins the feed late
+// and resyncs from the snapshot channel on port + 1; its recovered image is
+// checked against the book at the end. Passing "shm" as the address runs the
+// same flow over shared-memory transports instead of UDP.
+int main(int argc, char** argv)
+{
+    const char* address = argc > 1 ? argv[1] : "127.0.0.1";
+    const std::uint16_t port = static_cast<std::uint16_t>(argc > 2 ? std::atoi(argv[2]) : 9100);
+    const int NUM_ORDERS = argc > 3 ? std::atoi(argv[3]) : 1000000;
+    const int FLUSH_EVERY = argc > 4 ? std::max(1, std::atoi(argv[4])) : 16;
+
+    struct OrderEvent {
+        OrderType type;
+        OrderId id;
+        Side side;
+        Price price;
+        Quantity qty;
+    };
+
+    std::vector<OrderEvent> events;
+    events.reserve(NUM_ORDERS);
+
+    std::mt19937 rng(126456u);
+    std::uniform_int_distribution<int> qty_dist(1, 50);
+    std::bernoulli_distribution fak_dist(0.05);
+    std::uniform_int_distribution<int> offset_dist(0, 5);
+    std::normal_distribution<double> mid_step_dist(0.0, 0.25);
+
+    Price mid = 100;
+    for (int i = 0; i < NUM_ORDERS; ++i) {
+        mid = std::max<Price>(1, mid + static_cast<Price>(std::lround(mid_step_dist(rng))));
+        Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        const int offset = offset_dist(rng);
+        Price price = side == Side::Buy ? std::max<Price>(1, mid - offset) : mid + offset;
+        Quantity qty = static_cast<Quantity>(qty_dist(rng));
+        OrderType type = fak_dist(rng) ? OrderType::FillAndKill : OrderType::GoodTillCancel;
+        events.push_back({ type, static_cast<OrderId>(i) + 1, side, price, qty });
+    }
+
+    const bool useShm = std::string_view{ address } == "shm";
+    ShmLoopback deltaLoopback{ 4096 };
+    ShmLoopback snapshotLoopback{ 1024 };
+    UdpTransport deltaIn, deltaOut, snapshotIn, snapshotOut;
+    Transport* deltaRx = &deltaLoopback.B();
+    Transport* deltaTx = &deltaLoopback.A();
+    Transport* snapshotRx = &snapshotLoopback.B();
+    Transport* snapshotTx = &snapshotLoopback.A();
+
+    if (!useShm) {
+        const std::uint16_t snapshotPort = static_cast<std::uint16_t>(port + 1);
+        if (!deltaIn.Bind(address, port) || !snapshotIn.Bind(address, snapshotPort)
+            || !deltaOut.Connect(address, port) || !snapshotOut.Connect(address, snapshotPort)) {
+            std::cerr << "Failed to open UDP transports on " << address << ":" << port << std::endl;
+            return 1;
+        }
+        deltaRx = &deltaIn;
+        deltaTx = &deltaOut;
+        snapshotRx = &snapshotIn;
+        snapshotTx = &snapshotOut;
+    }
+
+    MarketDataReceiver receiver{ *deltaRx };
+    MarketDataReceiver snapshotReceiver{ *snapshotRx };
+    MarketDataPublisher publisher{ *deltaTx };
+    SnapshotService snapshots{ *snapshotTx };
+
+    std::atomic<bool> done{ false };
+    BookRecovery recovery;
+    const std::uint64_t JOIN_AFTER_DATAGRAMS = 1000;
+    std::thread consumer([&receiver, &snapshotReceiver, &recovery, &done, JOIN_AFTER_DATAGRAMS]() {
+        auto OnDelta = [&](std::uint64_t sequence, const MarketData::BookDelta& delta) {
+            if (receiver.Stats().packets_ > JOIN_AFTER_DATAGRAMS) recovery.OnDelta(sequence, delta);
+        };
+        auto OnSnapshot = [&](const char* data, std::size_t length, std::uint64_t) {
+            if (receiver.Stats().packets_ > JOIN_AFTER_DATAGRAMS) recovery.OnSnapshotDatagram(data, length);
+        };
+        while (!done.load(std::memory_order_acquire)) {
+            const std::size_t read = receiver.Poll(OnDelta) + snapshotReceiver.PollDatagrams(OnSnapshot);
+            if (!read) std::this_thread::yield();
+        }
+        while (receiver.Poll(OnDelta) + snapshotReceiver.PollDatagrams(OnSnapshot)) {}
+    });
+
+    OrderBook orderbook;
+    orderbook.Preheat(static_cast<std::size_t>(NUM_ORDERS));
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_ORDERS; ++i) {
+        const auto& event = events[i];
+        orderbook.AddOrder(event.type, event.id, event.side, event.price, event.qty);
+        const Trades& trades = orderbook.GetTrades();
+        const std::uint64_t eventTime = MarketData::NowNs();
+        publisher.PublishAdd(orderbook, event.side, event.price, trades, eventTime);
+        if ((i + 1) % FLUSH_EVERY == 0) publisher.Flush();
+        snapshots.Poll(orderbook, publisher.NextSequence(), eventTime);
+    }
+    publisher.Flush();
+    const auto end = std::chrono::steady_clock::now();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    const OrderBookLevelInfos infos = orderbook.GetOrderInfos();
+    auto Matches = [](const LevelInfos& expected, const auto& image) {
+        if (expected.size() != image.size()) return false;
+        auto it = image.begin();
+        for (const auto& level : expected)
+            if (level.price_ != it->first || level.quantity_ != (it++)->second) return false;
+        return true;
+    };
+    const bool consistent = recovery.IsSynced()
+        && Matches(infos.GetBids(), recovery.GetBids()) && Matches(infos.GetAsks(), recovery.GetAsks());
+
+    const PublisherStats& sent = publisher.Stats();
+    const SnapshotStats& snapshotStats = snapshots.Stats();
+    const RecoveryStats& recoveryStats = recovery.Stats();
+    const ReceiverStats& received = receiver.Stats();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "------------------------------------------------" << std::endl;
+    std::cout << "Orders: " << NUM_ORDERS << " (flush every " << FLUSH_EVERY << ")" << std::endl;
+    std::cout << "Deltas published: " << sent.deltas_ << std::endl;
+    std::cout << "Datagrams sent: " << sent.packets_ << " in " << sent.batches_ << " transport bursts" << std::endl;
+    std::cout << "Publish rate: " << static_cast<long long>(sent.packets_ / seconds) << " packets/sec, "
+              << static_cast<long long>(sent.deltas_ / seconds) << " deltas/sec" << std::endl;
+    std::cout << "Avg deltas per datagram: " << (sent.packets_ ? static_cast<double>(sent.deltas_) / sent.packets_ : 0.0) << std::endl;
+    std::cout << "Event -> send latency (avg): " << (sent.deltas_ ? sent.latencySumNs_ / sent.deltas_ : 0) << " ns" << std::endl;
+    std::cout << "Event -> send latency (max): " << sent.latencyMaxNs_ << " ns" << std::endl;
+    std::cout << "Datagrams received: " << received.packets_ << std::endl;
+    std::cout << "Deltas received: " << received.deltas_ << std::endl;
+    std::cout << "Gaps detected: " << received.gaps_ << " (" << received.missedDeltas_ << " deltas missed)" << std::endl;
+    std::cout << "Event -> receive latency (avg): " << (received.deltas_ ? received.latencySumNs_ / received.deltas_ : 0) << " ns" << std::endl;
+    std::cout << "Event -> receive latency (max): " << received.latencyMaxNs_ << " ns" << std::endl;
+    std::cout << "Snapshots sent: " << snapshotStats.snapshots_ << " (" << snapshotStats.packets_ << " datagrams, "
+              << snapshotStats.bytes_ << " bytes, last interval " << snapshots.IntervalNs() / 1000000 << " ms)" << std::endl;
+    std::cout << "Recovery: " << recoveryStats.recoveries_ << " resyncs, " << recoveryStats.snapshotsApplied_ << " snapshots applied, "
+              << recoveryStats.deltasReplayed_ << " deltas replayed" << std::endl;
+    std::cout << "Recovered image matches book: " << (consistent ? "yes" : "NO") << std::endl;
+    std::cout << "------------------------------------------------" << std::endl;
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+
+#include "OrderBook.h"
+
+// A market maker requotes ten levels a side per message: usually new sizes at
+// the same prices, and a shift of the whole ladder when the mid moves. The
+// same stream is applied as one MassQuote per message and as CancelOrder plus
+// AddOrder per level, and the cost per quote is compared.
+
+int main(int argc, char** argv)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int NUM_MESSAGES = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int LEVELS = argc > 2 ? std::atoi(argv[2]) : 10;
+    const int BACKGROUND_ORDERS = 10000;
+
+    struct Message
+    {
+        Price mid_;
+        std::vector<Quantity> quantities_;
+    };
+
+    std::mt19937 rng(2024u);
+    std::uniform_int_distribution<int> qty_dist(1, 100);
+    std::bernoulli_distribution move_dist(0.2);
+
+    std::vector<Message> messages;
+    messages.reserve(static_cast<std::size_t>(NUM_MESSAGES));
+    Price mid = 10000;
+    for (int m = 0; m < NUM_MESSAGES; ++m) {
+        if (move_dist(rng)) mid = std::clamp<Price>(mid + ((rng() % 2) ? 1 : -1), 9980, 10020);
+        Message message{ mid, {} };
+        for (int k = 0; k < 2 * LEVELS; ++k) message.quantities_.push_back(static_cast<Quantity>(qty_dist(rng)));
+        messages.push_back(std::move(message));
+    }
+
+    // Resting interest from other participants, far enough from the quotes
+    // that the mid, kept within 20 ticks of 10000, never trades into it.
+    auto Prepare = [&](OrderBook& book) {
+        book.Preheat(100000);
+        for (int i = 0; i < BACKGROUND_ORDERS; ++i) {
+            const Side side = (i % 2) ? Side::Sell : Side::Buy;
+            const Price offset = 50 + i % 200;
+            book.AddOrder(OrderType::GoodTillCancel, static_cast<OrderId>(i) + 1, side, side == Side::Buy ? 10000 - offset : 10000 + offset, 10);
+        }
+    };
+
+    auto QuotePrice = [LEVELS](Price mid, int k) {
+        return k < LEVELS ? mid - 1 - k : mid + 1 + (k - LEVELS);
+    };
+    auto QuoteSide = [LEVELS](int k) { return k < LEVELS ? Side::Buy : Side::Sell; };
+
+    const OrderId firstQuoteId = BACKGROUND_ORDERS + 1;
+
+    OrderBook massBook;
+    Prepare(massBook);
+    std::vector<QuoteEntry> quotes(static_cast<std::size_t>(2 * LEVELS));
+    const auto massStart = Clock::now();
+    for (const Message& message : messages) {
+        for (int k = 0; k < 2 * LEVELS; ++k)
+            quotes[k] = QuoteEntry{ firstQuoteId + static_cast<OrderId>(k), QuoteSide(k), QuotePrice(message.mid_, k), message.quantities_[k] };
+        massBook.MassQuote(quotes);
+    }
+    const auto massEnd = Clock::now();
+
+    OrderBook cancelAddBook;
+    Prepare(cancelAddBook);
+    std::vector<OrderId> live(static_cast<std::size_t>(2 * LEVELS), 0);
+    OrderId nextId = firstQuoteId;
+    const auto cancelAddStart = Clock::now();
+    for (const Message& message : messages) {
+        for (int k = 0; k < 2 * LEVELS; ++k) {
+            if (live[k]) cancelAddBook.CancelOrder(live[k]);
+            live[k] = nextId++;
+            cancelAddBook.AddOrder(OrderType::GoodTillCancel, live[k], QuoteSide(k), QuotePrice(message.mid_, k), message.quantities_[k]);
+        }
+    }
+    const auto cancelAddEnd = Clock::now();
+
+    const double quoteCount = static_cast<double>(NUM_MESSAGES) * 2 * LEVELS;
+    auto NsPerQuote = [quoteCount](Clock::duration d) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) / quoteCount;
+    };
+
+    std::cout << "------------------------------------------------" << std::endl;
+    std::cout << "Messages: " << NUM_MESSAGES << ", quotes per message: " << 2 * LEVELS << std::endl;
+    std::cout << "MassQuote: " << NsPerQuote(massEnd - massStart) << " ns per quote" << std::endl;
+    std::cout << "CancelOrder + AddOrder: " << NsPerQuote(cancelAddEnd - cancelAddStart) << " ns per quote" << std::endl;
+    std::cout << "Resting orders: " << massBook.Size() << " / " << cancelAddBook.Size() << std::endl;
+    std::cout << "------------------------------------------------" << std::endl;
+    return 0;
+}
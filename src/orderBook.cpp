@@ -4,13 +4,30 @@
 #include <random>
 #include <algorithm>
 #include <numeric>
+#include <cstdlib>
+#include <new>
 
 #include "OrderBook.h"
+#include "PerfCounters.h"
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+// Counts heap allocations so the benchmark can report how many the book makes
+// per order in the timed loop.
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    std::abort();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
 void PinThreadToCore(int core_id) {
 #ifdef _WIN32
     DWORD_PTR mask = (static_cast<DWORD_PTR>(1) << core_id);
@@ -23,12 +40,16 @@ void PinThreadToCore(int core_id) {
 #endif
 }
 
-int main()
+int main(int argc, char** argv)
 {
     PinThreadToCore(5);
 
     const int NUM_ORDERS = 2000000;
     const int REPEATS = 50;
+    // Ids rise through the session, so warm-up orders take the lowest ones.
+    const int WARMUP_ORDERS = 100;
+    // Mean of the per-order mid step; non-zero values give a trending market.
+    const double MID_DRIFT = argc > 1 ? std::atof(argv[1]) : 0.0;
 
     struct OrderEvent {
         OrderType type;
@@ -45,7 +66,7 @@ int main()
     std::uniform_int_distribution<int> qty_dist(1, 50);
     std::bernoulli_distribution fak_dist(0.05); // ~5% FillAndKill
     std::uniform_int_distribution<int> offset_dist(0, 5);
-    std::normal_distribution<double> mid_step_dist(0.0, 0.25);
+    std::normal_distribution<double> mid_step_dist(MID_DRIFT, 0.25);
 
     Price mid = 100;
     for (int i = 0; i < NUM_ORDERS; ++i) {
@@ -61,30 +82,49 @@ int main()
         Quantity qty = static_cast<Quantity>(qty_dist(rng));
         OrderType type = fak_dist(rng) ? OrderType::FillAndKill : OrderType::GoodTillCancel;
 
-        events.push_back({ type, static_cast<OrderId>(i) + 1, side, price, qty });
+        events.push_back({ type, static_cast<OrderId>(WARMUP_ORDERS + i) + 1, side, price, qty });
     }
 
-    auto run_once_ns = [&events]() -> std::pair<long long, std::size_t> {
+    PerfCounters counters;
+    PerfCounters::Sample totals;
+    std::size_t timedAllocations = 0;
+    BookMemoryUsage lastMemory;
+    std::uint64_t lastSparseOperations = 0;
+    std::uint64_t lastMigrations = 0;
+
+    auto run_once_ns = [&]() -> std::pair<long long, std::size_t> {
         OrderBook orderbook;
+        orderbook.Preheat(1000000);
 
-        for (int i = 0; i < 100; ++i) {
-            orderbook.AddOrder(OrderType::GoodTillCancel, 999999 + i, Side::Buy, 99, 1);
-            orderbook.CancelOrder(999999 + i);
+        for (int i = 0; i < WARMUP_ORDERS; ++i) {
+            orderbook.AddOrder(OrderType::GoodTillCancel, static_cast<OrderId>(i) + 1, Side::Buy, 99, 1);
+            orderbook.CancelOrder(static_cast<OrderId>(i) + 1);
         }
 
+        const std::size_t allocationsBefore = g_allocations;
+        counters.Start();
         const auto start = std::chrono::steady_clock::now();
         for (const auto& event : events) {
             orderbook.AddOrder(event.type, event.id, event.side, event.price, event.qty);
         }
         const auto end = std::chrono::steady_clock::now();
+        const auto sample = counters.Stop();
+        timedAllocations += g_allocations - allocationsBefore;
+        totals.instructions_ += sample.instructions_;
+        totals.cycles_ += sample.cycles_;
+        totals.branchMisses_ += sample.branchMisses_;
 
         const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        lastMemory = orderbook.GetMemoryUsage();
+        lastSparseOperations = orderbook.SparseLevelOperations();
+        lastMigrations = orderbook.LevelMigrations();
         return { static_cast<long long>(duration.count()), orderbook.Size() };
     };
 
     std::cout << "Warming up (not timed)..." << std::endl;
     (void)run_once_ns();
 
+    std::cout << "Mid drift per order: " << MID_DRIFT << ", final mid: " << mid << std::endl;
     std::cout << "Starting Consistency Mode: " << REPEATS << " runs of " << NUM_ORDERS << " orders..." << std::endl;
 
     std::vector<long long> durations_ns;
@@ -116,6 +156,54 @@ int main()
     std::cout << "Average Latency per Order (median): " << median_latency_ns << " ns" << std::endl;
     std::cout << "Throughput (from median): " << static_cast<long long>(1e9 / median_latency_ns) << " orders/sec" << std::endl;
     std::cout << "Resulting Orderbook Size (last run): " << last_book_size << std::endl;
+    auto PrintMemory = [](const char* label, const BookMemoryUsage& usage) {
+        std::cout << label << ": " << usage.Total() / 1024 << " KiB (pool " << usage.pool_ / 1024
+            << ", index " << usage.index_ / 1024 << ", levels " << usage.levels_ / 1024
+            << ", trades " << usage.trades_ / 1024 << ")" << std::endl;
+    };
+    PrintMemory("Memory (last run)", lastMemory);
+    if (last_book_size) std::cout << "Bytes per Resting Order (last run): " << lastMemory.Total() / last_book_size << std::endl;
+    OrderBook preheated;
+    preheated.Preheat(1000000);
+    PrintMemory("Memory (empty, preheated for 1M orders)", preheated.GetMemoryUsage());
+    PrintMemory("Memory (empty, default config)", OrderBook{}.GetMemoryUsage());
+    std::cout << "Sparse Level Operations (last run): " << lastSparseOperations << ", level migrations: " << lastMigrations << std::endl;
+
+    // Cancels every id once against a fully built book, so most target orders
+    // that have already filled.
+    OrderBook cancelBook;
+    cancelBook.Preheat(1000000);
+    for (const auto& event : events) cancelBook.AddOrder(event.type, event.id, event.side, event.price, event.qty);
+    const auto cancelStart = std::chrono::steady_clock::now();
+    for (const auto& event : events) cancelBook.CancelOrder(event.id);
+    const auto cancelEnd = std::chrono::steady_clock::now();
+    const CancelFilterStats& filterStats = cancelBook.GetCancelFilterStats();
+    std::cout << "Cancel Latency (" << filterStats.lookups_ - last_book_size << " of " << filterStats.lookups_ << " already gone): "
+        << static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(cancelEnd - cancelStart).count()) / NUM_ORDERS
+        << " ns, filter hit rate: " << filterStats.HitRate() << std::endl;
+
+    // The same cancels in batches, as they arrive in a cancel storm.
+    const std::size_t CANCEL_BATCH = 256;
+    std::vector<OrderId> cancelIds;
+    cancelIds.reserve(events.size());
+    for (const auto& event : events) cancelIds.push_back(event.id);
+    OrderBook batchBook;
+    batchBook.Preheat(1000000);
+    for (const auto& event : events) batchBook.AddOrder(event.type, event.id, event.side, event.price, event.qty);
+    const auto batchStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < cancelIds.size(); i += CANCEL_BATCH)
+        batchBook.CancelOrders(std::span<const OrderId>{ cancelIds }.subspan(i, std::min(CANCEL_BATCH, cancelIds.size() - i)));
+    const auto batchEnd = std::chrono::steady_clock::now();
+    std::cout << "Batch Cancel Latency (" << CANCEL_BATCH << " per batch): "
+        << static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(batchEnd - batchStart).count()) / NUM_ORDERS
+        << " ns" << std::endl;
+    std::cout << "Allocations per Order: " << static_cast<double>(timedAllocations) / (static_cast<double>(NUM_ORDERS) * (REPEATS + 1)) << std::endl;
+    if (counters.IsValid()) {
+        std::cout << "IPC: " << totals.Ipc() << std::endl;
+        std::cout << "Branch Misses per Order: " << static_cast<double>(totals.branchMisses_) / (static_cast<double>(NUM_ORDERS) * (REPEATS + 1)) << std::endl;
+    } else {
+        std::cout << "IPC: perf counters unavailable" << std::endl;
+    }
     std::cout << "------------------------------------------------" << std::endl;
 
     return 0;
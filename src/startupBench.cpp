@@ -0,0 +1,80 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <fstream>
+#include <cstdlib>
+
+#include <unistd.h>
+
+#include "OrderBook.h"
+
+// Builds many books the way a venue with a long tail of illiquid symbols
+// would, rests a handful of orders in each, and reports construction time
+// and resident memory.
+
+static std::size_t ResidentBytes()
+{
+    std::ifstream statm{ "/proc/self/statm" };
+    std::size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+int main(int argc, char** argv)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int NUM_BOOKS = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const int ORDERS_PER_BOOK = argc > 2 ? std::atoi(argv[2]) : 20;
+    const int HOT_BOOKS = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    // Illiquid books only see orders close to the touch, so a narrow dense
+    // ladder window is enough, and a few resting orders need only a short
+    // window of recent ids; preheated books keep the defaults.
+    OrderBookConfig illiquid;
+    illiquid.ladderTicks_ = 32;
+    illiquid.restingIdWindow_ = 4096;
+
+    std::vector<std::unique_ptr<OrderBook>> books;
+    books.reserve(static_cast<std::size_t>(NUM_BOOKS));
+
+    const std::size_t rssBefore = ResidentBytes();
+    const auto start = Clock::now();
+    for (int i = 0; i < NUM_BOOKS; ++i) {
+        if (i < HOT_BOOKS) {
+            books.push_back(std::make_unique<OrderBook>());
+            books.back()->Preheat(1000000);
+        } else {
+            books.push_back(std::make_unique<OrderBook>(illiquid));
+        }
+    }
+    const auto built = Clock::now();
+
+    OrderId id = 1;
+    for (auto& book : books) {
+        for (int i = 0; i < ORDERS_PER_BOOK; ++i) {
+            const Side side = (i % 2) ? Side::Sell : Side::Buy;
+            const Price price = side == Side::Buy ? 100 - i : 101 + i;
+            book->AddOrder(OrderType::GoodTillCancel, id++, side, price, 10);
+        }
+    }
+    const auto filled = Clock::now();
+    const std::size_t rssAfter = ResidentBytes();
+
+    std::size_t accounted = 0;
+    for (const auto& book : books) accounted += book->GetMemoryUsage().Total();
+
+    auto Ms = [](Clock::duration d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count() / 1000.0; };
+
+    std::cout << "------------------------------------------------" << std::endl;
+    std::cout << "Books: " << NUM_BOOKS << " (" << HOT_BOOKS << " preheated), " << ORDERS_PER_BOOK << " resting orders each" << std::endl;
+    std::cout << "Construction time: " << Ms(built - start) << " ms" << std::endl;
+    std::cout << "First orders time: " << Ms(filled - built) << " ms" << std::endl;
+    std::cout << "RSS growth: " << (rssAfter - rssBefore) / (1024 * 1024) << " MiB ("
+        << (rssAfter - rssBefore) / static_cast<std::size_t>(NUM_BOOKS) << " bytes per book)" << std::endl;
+    std::cout << "Accounted memory: " << accounted / (1024 * 1024) << " MiB ("
+        << accounted / static_cast<std::size_t>(NUM_BOOKS) << " bytes per book)" << std::endl;
+    std::cout << "------------------------------------------------" << std::endl;
+    return 0;
+}